@@ -22,6 +22,10 @@ void setup(void) {
     // thermal2.begin(&Wire, 0x32, 400000, 400000);
     thermal2.begin();
 
+    // Settings between beginConfig and commit are sent together.
+    // (only the changed registers, in as few I2C transfers as possible)
+    thermal2.beginConfig();
+
     // Sampling rate can be specified with values from 0~7.
     // The higher the sampling rate, the more noise is generated.
     // 0=1/2Hz  1=1Hz  2=2Hz  3=4Hz  4=8Hz  5=16Hz  6=32Hz  7=64Hz
@@ -62,6 +66,9 @@ void setup(void) {
     // All alarm on
     thermal2.alarmOn();
 
+    // Send the settings to the unit.
+    thermal2.commit();
+
     /* // ※ Temperature alarms can be based on four types of temperature
     information.
     // Lowest temp reached low threshold
@@ -106,7 +113,7 @@ void loop(void) {
         frame_count++;
 
         // Obtain temperature data structure.
-        auto temp_data = thermal2.getTemperatureData();
+        auto& temp_data = thermal2.getTemperatureData();
 
         // `getLowestTemperature` and `getHighestTemperature` of type float has
         // temperature in degrees Celsius.
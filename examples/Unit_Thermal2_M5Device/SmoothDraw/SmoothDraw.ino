@@ -2,6 +2,10 @@
 #include <M5Unified.h>  // https://github.com/m5stack/M5Unified/
 
 #include <M5_Thermal2.h>
+#include <M5_Thermal2_FrameAssembler.h>
+#include <M5_Thermal2_FrameRing.h>
+#include <M5_Thermal2_Histogram.h>
+#include <M5_Thermal2_Renderer.h>
 
 M5_Thermal2 thermal2;
 
@@ -20,169 +24,8 @@ static constexpr const int step_table[] = {1,  2,   5,   10,     20,
 
 const int32_t raw_zero = M5_Thermal2::convertCelsiusToRaw(0.0f);
 
-static constexpr const uint16_t color_map_table[][256] = {
-    {
-        // colormap_golden
-        0x0004, 0x0004, 0x0004, 0x0004, 0x0005, 0x0005, 0x0825, 0x0825, 0x0825,
-        0x0826, 0x0826, 0x0826, 0x1027, 0x1027, 0x1027, 0x1027, 0x1828, 0x1828,
-        0x1848, 0x1849, 0x2049, 0x2049, 0x204A, 0x204A, 0x284A, 0x284B, 0x284B,
-        0x284B, 0x306C, 0x306C, 0x306C, 0x386D, 0x386D, 0x386D, 0x408E, 0x408E,
-        0x408E, 0x408F, 0x488F, 0x488F, 0x4890, 0x5090, 0x50B0, 0x50B0, 0x58B1,
-        0x58B1, 0x58B1, 0x58B1, 0x60D2, 0x60D2, 0x60D2, 0x68D2, 0x68D2, 0x68D2,
-        0x68F3, 0x70F3, 0x70F3, 0x70F3, 0x78F3, 0x7913, 0x7913, 0x7913, 0x8113,
-        0x8133, 0x8133, 0x8133, 0x8933, 0x8932, 0x8952, 0x9152, 0x9152, 0x9152,
-        0x9151, 0x9971, 0x9971, 0x9971, 0x9970, 0xA190, 0xA190, 0xA18F, 0xA98F,
-        0xA9AF, 0xA9AE, 0xA9AE, 0xB1AD, 0xB1CD, 0xB1CD, 0xB9CC, 0xB9EC, 0xB9EB,
-        0xB9EB, 0xC1EB, 0xC20A, 0xC20A, 0xCA09, 0xCA29, 0xCA29, 0xCA28, 0xCA28,
-        0xD247, 0xD247, 0xD247, 0xDA66, 0xDA66, 0xDA65, 0xDA85, 0xDA85, 0xE284,
-        0xE2A4, 0xE2A4, 0xE2A3, 0xEAC3, 0xEAC3, 0xEAE2, 0xEAE2, 0xEAE2, 0xF2E2,
-        0xF301, 0xF301, 0xF321, 0xF321, 0xF321, 0xF340, 0xFB40, 0xFB40, 0xFB60,
-        0xFB60, 0xFB80, 0xFB80, 0xFB80, 0xFBA0, 0xFBA0, 0xFBC0, 0xFBC0, 0xFBE0,
-        0xFBE0, 0xFBE0, 0xFC00, 0xFC00, 0xFC20, 0xFC20, 0xFC40, 0xFC40, 0xFC60,
-        0xFC60, 0xFC80, 0xFC80, 0xFC80, 0xFCA0, 0xFCA0, 0xFCC0, 0xFCE0, 0xFCE0,
-        0xFD00, 0xFD00, 0xFD20, 0xFD20, 0xFD40, 0xFD40, 0xFD40, 0xFD60, 0xFD60,
-        0xFD80, 0xFDA0, 0xFDA0, 0xFDC0, 0xFDC0, 0xFDC1, 0xFDE1, 0xFDE1, 0xFE01,
-        0xFE01, 0xFE21, 0xFE21, 0xFE41, 0xFE42, 0xFE62, 0xFE62, 0xFE62, 0xFE82,
-        0xFE82, 0xFE83, 0xFEA3, 0xFEA3, 0xFEC3, 0xFEC3, 0xFEC3, 0xFEE3, 0xFEE4,
-        0xFEE4, 0xFF04, 0xFF04, 0xFF04, 0xFF25, 0xFF25, 0xFF25, 0xFF45, 0xFF46,
-        0xFF46, 0xFF46, 0xFF67, 0xFF67, 0xFF67, 0xFF68, 0xFF68, 0xFF89, 0xFF89,
-        0xFF89, 0xFF8A, 0xFF8A, 0xFFAB, 0xFFAB, 0xFFAC, 0xFFAC, 0xFFAD, 0xFFAD,
-        0xFFAE, 0xFFCE, 0xFFCE, 0xFFCF, 0xFFD0, 0xFFD0, 0xFFD1, 0xFFD1, 0xFFD2,
-        0xFFD2, 0xFFD3, 0xFFD3, 0xFFD4, 0xFFD4, 0xFFD5, 0xFFF5, 0xFFF6, 0xFFF6,
-        0xFFF7, 0xFFF7, 0xFFF8, 0xFFF8, 0xFFF9, 0xFFF9, 0xFFF9, 0xFFFA, 0xFFFA,
-        0xFFFB, 0xFFFB, 0xFFFC, 0xFFFC, 0xFFFC, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFE,
-        0xFFFE, 0xFFFE, 0xFFFF, 0xFFFF,
-    },
-    {
-        // colormap_rainbow
-        0x0009, 0x0009, 0x0009, 0x0009, 0x0009, 0x0009, 0x0009, 0x0009, 0x000A,
-        0x002A, 0x002B, 0x004B, 0x006B, 0x008C, 0x00AC, 0x00CC, 0x00ED, 0x010D,
-        0x010E, 0x012E, 0x014E, 0x014F, 0x0170, 0x0190, 0x0190, 0x0191, 0x01B1,
-        0x01B1, 0x01B1, 0x01B2, 0x01D2, 0x01D2, 0x01F3, 0x01F3, 0x0213, 0x0214,
-        0x0234, 0x0234, 0x0235, 0x0255, 0x0256, 0x0276, 0x0277, 0x0277, 0x0297,
-        0x0297, 0x02B8, 0x02B8, 0x02D9, 0x02D9, 0x02F9, 0x02F9, 0x02FA, 0x02FA,
-        0x031A, 0x031A, 0x031A, 0x033B, 0x033B, 0x035B, 0x035B, 0x035B, 0x037B,
-        0x037B, 0x039B, 0x039B, 0x03BB, 0x03BB, 0x03DB, 0x03DB, 0x03FB, 0x03FA,
-        0x041A, 0x0419, 0x0439, 0x0439, 0x0438, 0x0458, 0x0457, 0x0476, 0x0C75,
-        0x0C94, 0x0C94, 0x0C93, 0x0C93, 0x0C92, 0x0CB1, 0x14B0, 0x14CF, 0x1CCE,
-        0x1CED, 0x24EC, 0x2D0B, 0x2D0A, 0x3529, 0x3D28, 0x4547, 0x4D66, 0x4D66,
-        0x5585, 0x5D84, 0x5DA4, 0x65A3, 0x6DC3, 0x6DC2, 0x75E2, 0x75E2, 0x7DE2,
-        0x8601, 0x8601, 0x8E21, 0x8E21, 0x9620, 0x9640, 0x9E40, 0xA640, 0xA660,
-        0xAE60, 0xAE60, 0xAE60, 0xB660, 0xBE80, 0xBE80, 0xC680, 0xC6A0, 0xC6A0,
-        0xCEA0, 0xCEA0, 0xD6A0, 0xD6A0, 0xDEA0, 0xDEA0, 0xDEA0, 0xE6A0, 0xE6A0,
-        0xE6A0, 0xE680, 0xEE80, 0xEE80, 0xEE80, 0xEE80, 0xEE80, 0xEE80, 0xEE81,
-        0xEE61, 0xF661, 0xF641, 0xF641, 0xF641, 0xF641, 0xF621, 0xF621, 0xF621,
-        0xFE01, 0xFDE1, 0xFDE1, 0xFDC1, 0xFDC2, 0xFDA2, 0xFD82, 0xFD62, 0xFD42,
-        0xFD42, 0xFD22, 0xFD22, 0xFD02, 0xFD02, 0xFCE2, 0xFCE2, 0xFCC3, 0xFCA3,
-        0xFC63, 0xFC43, 0xFC23, 0xFC03, 0xFBE4, 0xFBA4, 0xFB64, 0xFB44, 0xFB24,
-        0xFB04, 0xFAE5, 0xFAC5, 0xFA85, 0xFA65, 0xFA25, 0xF9E6, 0xF9C6, 0xF9A6,
-        0xF986, 0xF966, 0xF927, 0xF907, 0xF907, 0xF8E7, 0xF8E7, 0xF8E7, 0xF8E7,
-        0xF8C7, 0xF8C8, 0xF8C8, 0xF8C8, 0xF8C8, 0xF8C9, 0xF0C9, 0xF0C9, 0xF0C9,
-        0xF0CA, 0xF10A, 0xF10A, 0xF12A, 0xF14B, 0xF16B, 0xF18B, 0xF9AB, 0xF9CC,
-        0xFA0C, 0xFA4C, 0xFA8D, 0xFAAD, 0xFAED, 0xFAED, 0xFB0D, 0xFB2D, 0xFB2E,
-        0xFB2E, 0xFB6E, 0xFBAF, 0xFBCF, 0xFBEF, 0xFC10, 0xFC30, 0xFC50, 0xFC91,
-        0xFCB1, 0xFCF2, 0xFD12, 0xFD52, 0xFD73, 0xFD93, 0xFD93, 0xFDD4, 0xFDF4,
-        0xFE15, 0xFE35, 0xFE55, 0xFE76, 0xFE96, 0xFED7, 0xFED7, 0xFEF8, 0xFEF9,
-        0xFF19, 0xFF19, 0xFF39, 0xFF5A,
-    },
-    {
-        // colormap_grayscale
-        0x0000, 0x0000, 0x0000, 0x0000, 0x0020, 0x0020, 0x0820, 0x0820, 0x0840,
-        0x0840, 0x0841, 0x0841, 0x0861, 0x0861, 0x1061, 0x1061, 0x1081, 0x1081,
-        0x1082, 0x1082, 0x10a2, 0x10a2, 0x18a2, 0x18a2, 0x18c2, 0x18c2, 0x18c3,
-        0x18c3, 0x18e3, 0x18e3, 0x20e3, 0x20e3, 0x2103, 0x2103, 0x2104, 0x2104,
-        0x2124, 0x2124, 0x2924, 0x2924, 0x2944, 0x2944, 0x2945, 0x2945, 0x2965,
-        0x2965, 0x3165, 0x3165, 0x3185, 0x3185, 0x3186, 0x3186, 0x31a6, 0x31a6,
-        0x39a6, 0x39a6, 0x39c6, 0x39c6, 0x39c7, 0x39c7, 0x39e7, 0x39e7, 0x41e7,
-        0x41e7, 0x4207, 0x4207, 0x4208, 0x4208, 0x4228, 0x4228, 0x4a28, 0x4a28,
-        0x4a48, 0x4a48, 0x4a49, 0x4a49, 0x4a69, 0x4a69, 0x5269, 0x5269, 0x5289,
-        0x5289, 0x528a, 0x528a, 0x52aa, 0x52aa, 0x5aaa, 0x5aaa, 0x5aca, 0x5aca,
-        0x5acb, 0x5acb, 0x5aeb, 0x5aeb, 0x62eb, 0x62eb, 0x630b, 0x630b, 0x630c,
-        0x630c, 0x632c, 0x632c, 0x6b2c, 0x6b2c, 0x6b4c, 0x6b4c, 0x6b4d, 0x6b4d,
-        0x6b6d, 0x6b6d, 0x736d, 0x736d, 0x738d, 0x738d, 0x738e, 0x738e, 0x73ae,
-        0x73ae, 0x7bae, 0x7bae, 0x7bce, 0x7bce, 0x7bcf, 0x7bcf, 0x7bef, 0x7bef,
-        0x83ef, 0x83ef, 0x840f, 0x840f, 0x8410, 0x8410, 0x8430, 0x8430, 0x8c30,
-        0x8c30, 0x8c50, 0x8c50, 0x8c51, 0x8c51, 0x8c71, 0x8c71, 0x9471, 0x9471,
-        0x9491, 0x9491, 0x9492, 0x9492, 0x94b2, 0x94b2, 0x9cb2, 0x9cb2, 0x9cd2,
-        0x9cd2, 0x9cd3, 0x9cd3, 0x9cf3, 0x9cf3, 0xa4f3, 0xa4f3, 0xa513, 0xa513,
-        0xa514, 0xa514, 0xa534, 0xa534, 0xad34, 0xad34, 0xad54, 0xad54, 0xad55,
-        0xad55, 0xad75, 0xad75, 0xb575, 0xb575, 0xb595, 0xb595, 0xb596, 0xb596,
-        0xb5b6, 0xb5b6, 0xbdb6, 0xbdb6, 0xbdd6, 0xbdd6, 0xbdd7, 0xbdd7, 0xbdf7,
-        0xbdf7, 0xc5f7, 0xc5f7, 0xc617, 0xc617, 0xc618, 0xc618, 0xc638, 0xc638,
-        0xce38, 0xce38, 0xce58, 0xce58, 0xce59, 0xce59, 0xce79, 0xce79, 0xd679,
-        0xd679, 0xd699, 0xd699, 0xd69a, 0xd69a, 0xd6ba, 0xd6ba, 0xdeba, 0xdeba,
-        0xdeda, 0xdeda, 0xdedb, 0xdedb, 0xdefb, 0xdefb, 0xe6fb, 0xe6fb, 0xe71b,
-        0xe71b, 0xe71c, 0xe71c, 0xe73c, 0xe73c, 0xef3c, 0xef3c, 0xef5c, 0xef5c,
-        0xef5d, 0xef5d, 0xef7d, 0xef7d, 0xf77d, 0xf77d, 0xf79d, 0xf79d, 0xf79e,
-        0xf79e, 0xf7be, 0xf7be, 0xffbe, 0xffbe, 0xffde, 0xffde, 0xffdf, 0xffdf,
-        0xffff, 0xffff, 0xffff, 0xffff,
-    },
-    {
-        // colormap_ironblack
-        0xFFFF, 0xFFFF, 0xFFDF, 0xFFDF, 0xF7BE, 0xF7BE, 0xF79E, 0xF79E, 0xEF7D,
-        0xEF7D, 0xEF5D, 0xEF5D, 0xE73C, 0xE73C, 0xE71C, 0xE71C, 0xDEFB, 0xDEFB,
-        0xDEDB, 0xDEDB, 0xD6BA, 0xD6BA, 0xD69A, 0xD69A, 0xCE79, 0xCE79, 0xCE59,
-        0xCE59, 0xC638, 0xC638, 0xC618, 0xC618, 0xBDF7, 0xBDF7, 0xBDD7, 0xBDD7,
-        0xB5B6, 0xB5B6, 0xB596, 0xB596, 0xAD75, 0xAD75, 0xAD55, 0xAD55, 0xA534,
-        0xA534, 0xA514, 0xA514, 0x9CF3, 0x9CF3, 0x9CD3, 0x9CD3, 0x94B2, 0x94B2,
-        0x9492, 0x9492, 0x8C71, 0x8C71, 0x8C51, 0x8C51, 0x8430, 0x8430, 0x8410,
-        0x8410, 0x7BEF, 0x7BEF, 0x7BCF, 0x7BCF, 0x73AE, 0x73AE, 0x738E, 0x738E,
-        0x6B6D, 0x6B6D, 0x6B4D, 0x6B4D, 0x632C, 0x632C, 0x630C, 0x630C, 0x5AEB,
-        0x5AEB, 0x5ACB, 0x5ACB, 0x52AA, 0x52AA, 0x528A, 0x528A, 0x4A69, 0x4A69,
-        0x4A49, 0x4A49, 0x4228, 0x4228, 0x4208, 0x4208, 0x39E7, 0x39E7, 0x39C7,
-        0x39C7, 0x31A6, 0x31A6, 0x3186, 0x3186, 0x2965, 0x2965, 0x2945, 0x2945,
-        0x2124, 0x2124, 0x2104, 0x2104, 0x18E3, 0x18E3, 0x18C3, 0x18C3, 0x10A2,
-        0x10A2, 0x1082, 0x1082, 0x0861, 0x0861, 0x0841, 0x0841, 0x0020, 0x0020,
-        0x0000, 0x0000, 0x0001, 0x0002, 0x0003, 0x0003, 0x0804, 0x0805, 0x0806,
-        0x0807, 0x1008, 0x1009, 0x100A, 0x100B, 0x180C, 0x180C, 0x180D, 0x180E,
-        0x200F, 0x280F, 0x280F, 0x300F, 0x380F, 0x380F, 0x400F, 0x400F, 0x4810,
-        0x5010, 0x5010, 0x5810, 0x6010, 0x6010, 0x6810, 0x6810, 0x7011, 0x7811,
-        0x7811, 0x8011, 0x8011, 0x8811, 0x9011, 0x9031, 0x9831, 0x9831, 0xA031,
-        0xA031, 0xA831, 0xB031, 0xB031, 0xB831, 0xB851, 0xB870, 0xC08F, 0xC08F,
-        0xC0AE, 0xC8CD, 0xC8ED, 0xC8EC, 0xC90B, 0xD12B, 0xD14A, 0xD14A, 0xD969,
-        0xD988, 0xD9A8, 0xD9A7, 0xE1C6, 0xE1E5, 0xE205, 0xE205, 0xE224, 0xE244,
-        0xE264, 0xE284, 0xE2A3, 0xEAC3, 0xEAE3, 0xEAE2, 0xEB02, 0xEB22, 0xEB41,
-        0xEB61, 0xEB81, 0xF3A1, 0xF3A1, 0xF3C1, 0xF3E1, 0xF401, 0xF421, 0xF441,
-        0xF461, 0xF481, 0xF4A1, 0xF4C1, 0xF4E1, 0xF501, 0xF501, 0xF521, 0xF541,
-        0xFD61, 0xFD81, 0xFDA2, 0xFDC2, 0xFDE2, 0xFE02, 0xFE22, 0xFE22, 0xFE42,
-        0xFE63, 0xFE83, 0xFEA3, 0xFEC3, 0xFEE3, 0xFF03, 0xFF04, 0xFF26, 0xFF28,
-        0xFF4A, 0xFF4B, 0xFF6D, 0xFF6F, 0xFF91, 0xFF92, 0xFFB4, 0xFFB6, 0xFFD8,
-        0xFFD9, 0xFFDB, 0xFFFD, 0xFFE3,
-    },
-    {
-        // colormap_cam
-        0x480F, 0x400F, 0x400F, 0x400F, 0x4010, 0x3810, 0x3810, 0x3810, 0x3810,
-        0x3010, 0x3010, 0x3010, 0x2810, 0x2810, 0x2810, 0x2810, 0x2010, 0x2010,
-        0x2010, 0x1810, 0x1810, 0x1811, 0x1811, 0x1011, 0x1011, 0x1011, 0x0811,
-        0x0811, 0x0811, 0x0011, 0x0011, 0x0011, 0x0011, 0x0011, 0x0031, 0x0031,
-        0x0051, 0x0072, 0x0072, 0x0092, 0x00B2, 0x00B2, 0x00D2, 0x00F2, 0x00F2,
-        0x0112, 0x0132, 0x0152, 0x0152, 0x0172, 0x0192, 0x0192, 0x01B2, 0x01D2,
-        0x01F3, 0x01F3, 0x0213, 0x0233, 0x0253, 0x0253, 0x0273, 0x0293, 0x02B3,
-        0x02D3, 0x02D3, 0x02F3, 0x0313, 0x0333, 0x0333, 0x0353, 0x0373, 0x0394,
-        0x03B4, 0x03D4, 0x03D4, 0x03F4, 0x0414, 0x0434, 0x0454, 0x0474, 0x0474,
-        0x0494, 0x04B4, 0x04D4, 0x04F4, 0x0514, 0x0534, 0x0534, 0x0554, 0x0554,
-        0x0574, 0x0574, 0x0573, 0x0573, 0x0573, 0x0572, 0x0572, 0x0572, 0x0571,
-        0x0591, 0x0591, 0x0590, 0x0590, 0x058F, 0x058F, 0x058F, 0x058E, 0x05AE,
-        0x05AE, 0x05AD, 0x05AD, 0x05AD, 0x05AC, 0x05AC, 0x05AB, 0x05CB, 0x05CB,
-        0x05CA, 0x05CA, 0x05CA, 0x05C9, 0x05C9, 0x05C8, 0x05E8, 0x05E8, 0x05E7,
-        0x05E7, 0x05E6, 0x05E6, 0x05E6, 0x05E5, 0x05E5, 0x0604, 0x0604, 0x0604,
-        0x0603, 0x0603, 0x0602, 0x0602, 0x0601, 0x0621, 0x0621, 0x0620, 0x0620,
-        0x0620, 0x0620, 0x0E20, 0x0E20, 0x0E40, 0x1640, 0x1640, 0x1E40, 0x1E40,
-        0x2640, 0x2640, 0x2E40, 0x2E60, 0x3660, 0x3660, 0x3E60, 0x3E60, 0x3E60,
-        0x4660, 0x4660, 0x4E60, 0x4E80, 0x5680, 0x5680, 0x5E80, 0x5E80, 0x6680,
-        0x6680, 0x6E80, 0x6EA0, 0x76A0, 0x76A0, 0x7EA0, 0x7EA0, 0x86A0, 0x86A0,
-        0x8EA0, 0x8EC0, 0x96C0, 0x96C0, 0x9EC0, 0x9EC0, 0xA6C0, 0xAEC0, 0xAEC0,
-        0xB6E0, 0xB6E0, 0xBEE0, 0xBEE0, 0xC6E0, 0xC6E0, 0xCEE0, 0xCEE0, 0xD6E0,
-        0xD700, 0xDF00, 0xDEE0, 0xDEC0, 0xDEA0, 0xDE80, 0xDE80, 0xE660, 0xE640,
-        0xE620, 0xE600, 0xE5E0, 0xE5C0, 0xE5A0, 0xE580, 0xE560, 0xE540, 0xE520,
-        0xE500, 0xE4E0, 0xE4C0, 0xE4A0, 0xE480, 0xE460, 0xEC40, 0xEC20, 0xEC00,
-        0xEBE0, 0xEBC0, 0xEBA0, 0xEB80, 0xEB60, 0xEB40, 0xEB20, 0xEB00, 0xEAE0,
-        0xEAC0, 0xEAA0, 0xEA80, 0xEA60, 0xEA40, 0xF220, 0xF200, 0xF1E0, 0xF1C0,
-        0xF1A0, 0xF180, 0xF160, 0xF140, 0xF100, 0xF0E0, 0xF0C0, 0xF0A0, 0xF080,
-        0xF060, 0xF040, 0xF020, 0xF800,
-    }};
 static constexpr const size_t color_map_table_len =
-    (sizeof(color_map_table) / sizeof(color_map_table[0]));
+    M5_Thermal2_ColorMap::colormap_max;
 volatile size_t color_map_table_idx = 0;
 
 struct framedata_t {
@@ -200,10 +43,9 @@ struct framedata_t {
     uint8_t high_x;
     uint8_t high_y;
 };
-static constexpr size_t framedata_len = 4;
-framedata_t framedata[framedata_len];
-
-volatile int idx_recv = -1;
+// Assembled on the acquisition side (loop), handed to drawTask.
+framedata_t frame_work;
+M5_Thermal2_TripleBuffer<framedata_t> frame_buffer;
 
 struct rect_t {
     uint16_t x;
@@ -247,7 +89,9 @@ rect_t graph_rect;
 struct draw_param_t {
     LovyanGFX* gfx;
     const framedata_t* frame;
-    const uint16_t* color_map = color_map_table[0];
+    M5_Thermal2_Histogram histogram;
+    const uint16_t* color_map =
+        M5_Thermal2_ColorMap::getTable(M5_Thermal2_ColorMap::colormap_golden);
     int32_t temp_lowest;
     int32_t temp_highest;
     int32_t temp_diff;
@@ -262,29 +106,27 @@ struct draw_param_t {
     };
     marker_mode_t marker_mode = marker_mode_t::marker_mode_highest;
 
-    void setup(LovyanGFX* gfx_, framedata_t* frame_array_, int frameindex) {
+    void setup(LovyanGFX* gfx_, const framedata_t* frame_) {
         gfx = gfx_;
         for (int i = 0; i < 2; ++i) {
             _canvas[i].setFont(gfx_->getFont());
             _canvas[i].setPsram(false);
         }
-        _frame_array = frame_array_;
-        frame        = &frame_array_[frameindex];
-        _lowest_value.set(frame->temp[frame->lowest]);
-        _highest_value.set(frame->temp[frame->highest]);
-        update(frameindex);
-        _prev_frameindex = -1;
+        _lowest_value.set(frame_->temp[frame_->lowest]);
+        _highest_value.set(frame_->temp[frame_->highest]);
+        update(frame_);
     }
 
     void setColorTable(const uint16_t* tbl) {
         color_map = tbl;
     }
 
-    bool update(int frameindex) {
-        bool result = _prev_frameindex != frameindex;
+    // new_frame: newly received frame, or nullptr if there is none.
+    bool update(const framedata_t* new_frame) {
+        bool result = new_frame != nullptr;
         if (result) {
-            _prev_frameindex = frameindex;
-            frame            = &_frame_array[frameindex];
+            frame = new_frame;
+            histogram.update(frame->pixel_raw, frame_width * frame_height);
             ++update_count;
         }
         int32_t lowest  = frame->temp[frame->lowest];
@@ -343,8 +185,6 @@ struct draw_param_t {
         int32_t _current;
     };
 
-    uint8_t _prev_frameindex;
-    const framedata_t* _frame_array;
     M5Canvas _canvas[2];
     bool _canvas_idx = false;
     value_smooth_t _lowest_value;
@@ -472,90 +312,78 @@ class image_ui_t : public ui_base_t {
         clearInvalidate();
 
         if (_client_rect.empty()) return false;
-        int y1 = 0;
-        for (int fy = 1; fy < frame_height; ++fy) {
-            int y0        = y1;
-            y1            = (fy * _client_rect.h) / (frame_height - 1);
-            int boxHeight = y1 - y0;
-            if (boxHeight == 0) continue;
+        if (_renderer.width() != _client_rect.w ||
+            _renderer.height() != _client_rect.h) {
+            _renderer.setSize(_client_rect.w, _client_rect.h);
+        }
+        if (_color_map != param->color_map) {
+            _color_map = param->color_map;
+            _renderer.setColorMap(_color_map);
+            _renderer.setSwap565(true);
+        }
+        _renderer.setRange(param->temp_lowest,
+                           param->temp_lowest + param->temp_diff - 1);
+
+        // Rows are collected into strips, which are sent while the next
+        // strip is rendered.
+        _param        = param;
+        _strip_height = (_client_rect.h - 1) / (frame_height - 1) + 1;
+        _renderer.render(param->frame->pixel_raw, _drawRow, this);
+        return true;
+    };
 
-            auto img = param->getCanvas(
-                _client_rect.w, (_client_rect.h - 1) / (frame_height - 1) + 1);
-
-            int v0;
-            int v1 = ((param->frame->pixel_raw[(fy - 1) * frame_width] -
-                       param->temp_lowest)
-                      << 16) /
-                     boxHeight;
-            int v2;
-            int v3 = ((param->frame->pixel_raw[(fy)*frame_width] -
-                       param->temp_lowest)
-                      << 16) /
-                     boxHeight;
-
-            int x1 = 0;
-            for (int fx = 1; fx < frame_width; ++fx) {
-                int x0       = x1;
-                x1           = (fx * _client_rect.w) / (frame_width - 1);
-                int boxWidth = x1 - x0;
-                v0           = v1;
-                v1 = ((param->frame->pixel_raw[fx + (fy - 1) * frame_width] -
-                       param->temp_lowest)
-                      << 16) /
-                     boxHeight;
-                v2 = v3;
-                v3 = ((param->frame->pixel_raw[fx + (fy)*frame_width] -
-                       param->temp_lowest)
-                      << 16) /
-                     boxHeight;
-                if (boxWidth == 0) continue;
-                int divider = boxWidth * param->temp_diff;
-
-                for (int by = 0; by < boxHeight; ++by) {
-                    int v02 = (v0 * (boxHeight - by) + v2 * by) / divider;
-                    int v13 = (v1 * (boxHeight - by) + v3 * by) / divider;
-                    auto img_buf =
-                        &((m5gfx::swap565_t*)
-                              img->getBuffer())[x0 + by * img->width()];
-                    for (int bx = 0; bx < boxWidth; ++bx) {
-                        int v       = (v02 * (boxWidth - bx) + v13 * bx) >> 8;
-                        img_buf[bx] = m5gfx::getSwap16(
-                            (param->color_map[(v < 0)     ? 0
-                                              : (v > 255) ? 255
-                                                          : v]));
-                    }
-                }
-            }
+   private:
+    M5_Thermal2_Renderer _renderer;
+    const uint16_t* _color_map = nullptr;
+    draw_param_t* _param;
+    M5Canvas* _strip;
+    int _strip_height;
+
+    static void _drawRow(void* user, uint16_t y, const uint16_t* row,
+                         uint16_t width) {
+        auto self = (image_ui_t*)user;
+        int sy    = y % self->_strip_height;
+        if (sy == 0) {
+            self->_strip = self->_param->getCanvas(width, self->_strip_height);
+        }
+        memcpy(&((uint16_t*)self->_strip->getBuffer())[sy * width], row,
+               width * sizeof(uint16_t));
+        if (sy + 1 == self->_strip_height ||
+            y + 1 == self->_client_rect.h) {
+            self->_pushStrip(y - sy, sy + 1);
+        }
+    }
 
-            if (abs((y0 + y1) - (_marker.mark_y * 2)) < 20) {
-                img->setColor(abs(15 - (int)(31 & param->update_count)) *
-                              0x0F0F0Fu);
-                int x = _marker.mark_x;
-                int y = _marker.mark_y - y0;
-                img->drawCircle(x, y, 4);
-                img->drawFastVLine(x, y - 6, 13);
-                img->drawFastHLine(x - 6, y, 13);
-            }
+    void _pushStrip(int y0, int h) {
+        auto img = _strip;
+        int y1   = y0 + h;
+        if (abs((y0 + y1) - (_marker.mark_y * 2)) < 20) {
+            img->setColor(abs(15 - (int)(31 & _param->update_count)) *
+                          0x0F0F0Fu);
+            int x = _marker.mark_x;
+            int y = _marker.mark_y - y0;
+            img->drawCircle(x, y, 4);
+            img->drawFastVLine(x, y - 6, 13);
+            img->drawFastHLine(x - 6, y, 13);
+        }
 
-            if (abs((y0 + y1) - (_marker.text_y * 2)) < 20) {
-                img->setTextSize(1);
-                img->setTextDatum(textdatum_t::middle_center);
-                img->setTextColor(TFT_BLACK);
-                int x = _marker.text_x;
-                int y = _marker.text_y - y0;
-                img->drawString(_marker.text, x - 1, y);
-                img->drawString(_marker.text, x + 1, y);
-                img->drawString(_marker.text, x, y - 1);
-                img->drawString(_marker.text, x, y + 1);
-                img->setTextColor(TFT_WHITE);
-                img->drawString(_marker.text, x, y);
-            }
-            param->gfx->setClipRect(_client_rect.x, _client_rect.y + y0,
-                                    _client_rect.w, boxHeight);
-            img->pushSprite(param->gfx, _client_rect.x, _client_rect.y + y0);
+        if (abs((y0 + y1) - (_marker.text_y * 2)) < 20) {
+            img->setTextSize(1);
+            img->setTextDatum(textdatum_t::middle_center);
+            img->setTextColor(TFT_BLACK);
+            int x = _marker.text_x;
+            int y = _marker.text_y - y0;
+            img->drawString(_marker.text, x - 1, y);
+            img->drawString(_marker.text, x + 1, y);
+            img->drawString(_marker.text, x, y - 1);
+            img->drawString(_marker.text, x, y + 1);
+            img->setTextColor(TFT_WHITE);
+            img->drawString(_marker.text, x, y);
         }
-        return true;
-    };
+        _param->gfx->setClipRect(_client_rect.x, _client_rect.y + y0,
+                                 _client_rect.w, h);
+        img->pushSprite(_param->gfx, _client_rect.x, _client_rect.y + y0);
+    }
 };
 
 class graph_ui_t : public ui_base_t {
@@ -839,15 +667,10 @@ class hist_ui_t : public ui_base_t {
             memset(_prev_hist_line, 0, hist_len * sizeof(_prev_hist_line[0]));
         }
 
-        // Histogram Aggregation.
-        int hist_max = _client_rect.h - 1;
-        for (int idx = 0; idx < frame_width * frame_height; ++idx) {
-            int hist_idx = (param->frame->pixel_raw[idx] - param->temp_lowest) *
-                           _client_rect.h / param->temp_diff;
-            ++_histgram[(hist_idx < 0)
-                            ? 0
-                            : ((hist_idx > hist_max) ? hist_max : hist_idx)];
-        }
+        // Histogram of the display range. (counted once per frame)
+        param->histogram.getHistogram(param->temp_lowest,
+                                      param->temp_lowest + param->temp_diff - 1,
+                                      _histgram, _client_rect.h);
         int step_index = 0;
         while ((param->temp_diff >> 3) >
                _client_rect.h * step_table[step_index]) {
@@ -900,7 +723,6 @@ class hist_ui_t : public ui_base_t {
             if (i >= 0) {
                 int x =
                     ((_histgram[i] * _client_rect.w * _client_rect.h) >> 13);
-                _histgram[i] = 0;
                 x = (x < 0) ? 0 : (x > _client_rect.w) ? _client_rect.w : x;
                 int px          = _prev_hist_x[i];
                 _prev_hist_x[i] = x;
@@ -950,12 +772,16 @@ void drawTask(void*) {
         display.setFont(&fonts::DejaVu12);
     }
 
+    // Wait until both subpages have been received.
+    const framedata_t* frame;
     do {
         vTaskDelay(1);
-    } while (idx_recv < 2);
+    } while (frame_buffer.getWriteCount() < 3 ||
+             !(frame = frame_buffer.beginRead()));
 
-    draw_param.setup(&display, framedata, 2);
-    draw_param.setColorTable(color_map_table[0]);
+    draw_param.setup(&display, frame);
+    draw_param.setColorTable(
+        M5_Thermal2_ColorMap::getTable(M5_Thermal2_ColorMap::colormap_golden));
     graph_ui.setup(&draw_param);
 
     uint8_t prev_color_table_idx = 0;
@@ -984,7 +810,8 @@ void drawTask(void*) {
 
         if (prev_color_table_idx != color_map_table_idx) {
             prev_color_table_idx = color_map_table_idx;
-            draw_param.setColorTable(color_map_table[prev_color_table_idx]);
+            draw_param.setColorTable(M5_Thermal2_ColorMap::getTable(
+                (M5_Thermal2_ColorMap::color_map_t)prev_color_table_idx));
             image_ui.invalidate();
             graph_ui.invalidate();
             hist_ui.invalidate();
@@ -997,7 +824,7 @@ void drawTask(void*) {
 
         int drawcount = 0;
         for (int i = 0; i < 4; ++i) {
-            if (draw_param.update(idx_recv)) {
+            if (draw_param.update(frame_buffer.beginRead())) {
                 graph_ui.update(&draw_param);
                 text_ui.update(&draw_param);
             }
@@ -1157,12 +984,10 @@ void loop(void) {
     if (!thermal2.update()) {
         delay(1);
     } else {
-        int idx_recv_next = (idx_recv + 1) & 3;
-        auto frame        = &framedata[idx_recv_next];
-        auto prev_frame   = &framedata[idx_recv & 3];
-        memcpy(frame, prev_frame, sizeof(framedata_t));
+        // The previous frame is kept in frame_work and updated in place.
+        auto frame = &frame_work;
         // Obtain temperature data structure.
-        auto temp_data = thermal2.getTemperatureData();
+        auto& temp_data = thermal2.getTemperatureData();
         {
             static uint16_t prev_lowest = 0;
             auto lowest                 = temp_data.getLowestRaw();
@@ -1194,63 +1019,16 @@ void loop(void) {
             prev_average                 = average;
         }
 
-        uint16_t diff[384];
         // Pixel data is held in an array. Array size is 384. (16x24)
-        bool subpage   = temp_data.getSubPage();
-        frame->subpage = subpage;
-        for (int idx = 0; idx < 384; ++idx) {
-            uint_fast8_t y       = idx >> 4;
-            uint_fast8_t x       = ((idx & 15) << 1) + ((y & 1) != subpage);
-            uint_fast16_t xy     = x + y * frame_width;
-            int32_t raw          = temp_data.getPixelRaw(idx);
-            diff[idx]            = abs(raw - (int32_t)frame->pixel_raw[xy]);
-            frame->pixel_raw[xy] = raw;
-        }
-
-        // Interpolation is performed from surrounding pixels where the
-        // temperature change is large. (Areas with little temperature change
-        // inherit values from the previous frame.)
-        for (int idx = 0; idx < 384; ++idx) {
-            uint_fast8_t y   = idx >> 4;
-            uint_fast8_t x   = ((idx & 15) << 1) + ((y & 1) == subpage);
-            uint_fast16_t xy = x + y * frame_width;
-
-            uint32_t sum = 0;
-            size_t count = 0;
-            if (x > 0) {
-                ++count;
-                sum += diff[(xy - 1) >> 1];
-            }
-            if (x < (frame_width - 1)) {
-                ++count;
-                sum += diff[(xy + 1) >> 1];
-            }
-            if (y > 0) {
-                ++count;
-                sum += diff[(xy - frame_width) >> 1];
-            }
-            if (y < (frame_height - 1)) {
-                ++count;
-                sum += diff[(xy + frame_width) >> 1];
-            }
-            if (sum >= (count << 7)) {
-                sum = 0;
-                if (x > 0) {
-                    sum += frame->pixel_raw[xy - 1];
-                }
-                if (x < (frame_width - 1)) {
-                    sum += frame->pixel_raw[xy + 1];
-                }
-                if (y > 0) {
-                    sum += frame->pixel_raw[xy - frame_width];
-                }
-                if (y < (frame_height - 1)) {
-                    sum += frame->pixel_raw[xy + frame_width];
-                }
-                frame->pixel_raw[xy] = (sum + (count >> 1)) / count;
-            }
-        }
-
-        idx_recv = idx_recv_next;
+        // Merge it into the 32x24 frame. Where the temperature change is
+        // large, the pixels of the other subpage are interpolated from the
+        // surrounding pixels. (Areas with little temperature change inherit
+        // values from the previous frame.)
+        frame->subpage = temp_data.getSubPage();
+        M5_Thermal2_FrameAssembler::merge(temp_data, frame->pixel_raw);
+
+        // Hand the completed frame to drawTask without blocking it.
+        memcpy(frame_buffer.beginWrite(), frame, sizeof(framedata_t));
+        frame_buffer.commitWrite();
     }
 }
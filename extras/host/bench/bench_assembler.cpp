@@ -0,0 +1,141 @@
+// Host benchmark of M5_Thermal2_FrameAssembler.
+//
+// Compares the library assembler against the per-pixel code of the
+// SmoothDraw example (reference) on subpages captured from the simulator,
+// checks that both produce identical frames and reports the cost per frame.
+
+#include <Wire.h>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_RDTSC 1
+#endif
+
+#include "M5_Thermal2.h"
+#include "M5_Thermal2_FrameAssembler.h"
+#include "M5_Thermal2_Simulator.h"
+
+static constexpr int frame_width  = 32;
+static constexpr int frame_height = 24;
+
+// De-interleave and fill as in examples/SmoothDraw (before the library had
+// an assembler).
+static void reference(const M5_Thermal2::temperature_data_t& temp_data,
+                      uint16_t* pixel_raw) {
+    uint16_t diff[384];
+    bool subpage = temp_data.getSubPage();
+    for (int idx = 0; idx < 384; ++idx) {
+        uint_fast8_t y   = idx >> 4;
+        uint_fast8_t x   = ((idx & 15) << 1) + ((y & 1) != subpage);
+        uint_fast16_t xy = x + y * frame_width;
+        int32_t raw      = temp_data.getPixelRaw(idx);
+        diff[idx]        = abs(raw - (int32_t)pixel_raw[xy]);
+        pixel_raw[xy]    = raw;
+    }
+    for (int idx = 0; idx < 384; ++idx) {
+        uint_fast8_t y   = idx >> 4;
+        uint_fast8_t x   = ((idx & 15) << 1) + ((y & 1) == subpage);
+        uint_fast16_t xy = x + y * frame_width;
+
+        uint32_t sum = 0;
+        size_t count = 0;
+        if (x > 0) {
+            ++count;
+            sum += diff[(xy - 1) >> 1];
+        }
+        if (x < (frame_width - 1)) {
+            ++count;
+            sum += diff[(xy + 1) >> 1];
+        }
+        if (y > 0) {
+            ++count;
+            sum += diff[(xy - frame_width) >> 1];
+        }
+        if (y < (frame_height - 1)) {
+            ++count;
+            sum += diff[(xy + frame_width) >> 1];
+        }
+        if (sum >= (count << 7)) {
+            sum = 0;
+            if (x > 0) {
+                sum += pixel_raw[xy - 1];
+            }
+            if (x < (frame_width - 1)) {
+                sum += pixel_raw[xy + 1];
+            }
+            if (y > 0) {
+                sum += pixel_raw[xy - frame_width];
+            }
+            if (y < (frame_height - 1)) {
+                sum += pixel_raw[xy + frame_width];
+            }
+            pixel_raw[xy] = (sum + (count >> 1)) / count;
+        }
+    }
+}
+
+static inline uint64_t ticks(void) {
+#if HAVE_RDTSC
+    return __rdtsc();
+#else
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+int main(int argc, char** argv) {
+    const int count  = 256;
+    const int rounds = (argc > 1) ? atoi(argv[1]) : 200;
+
+    static M5_Thermal2::temperature_data_t subpages[count];
+    M5_Thermal2_Simulator sim(&Wire);
+    sim.setNoise(96);
+    Wire.attach(&sim);
+    M5_Thermal2 thermal2;
+    thermal2.begin(&Wire, M5_Thermal2::i2c_default_addr, 400000, 800000);
+    thermal2.setRefreshRate(M5_Thermal2::rate_64Hz);
+    for (int i = 0; i < count;) {
+        if (thermal2.update(subpages[i])) {
+            ++i;
+        } else {
+            delay(1);
+        }
+    }
+
+    static uint16_t ref[count][frame_width * frame_height];
+    static uint16_t lib[count][frame_width * frame_height];
+    uint16_t ref_frame[frame_width * frame_height] = {};
+    uint16_t lib_frame[frame_width * frame_height] = {};
+    for (int i = 0; i < count; ++i) {
+        reference(subpages[i], ref_frame);
+        M5_Thermal2_FrameAssembler::merge(subpages[i], lib_frame);
+        memcpy(ref[i], ref_frame, sizeof(ref_frame));
+        memcpy(lib[i], lib_frame, sizeof(lib_frame));
+    }
+    if (memcmp(ref, lib, sizeof(ref))) {
+        printf("assembler output differs from the reference\n");
+        return 1;
+    }
+
+    uint64_t t_ref = 0, t_lib = 0;
+    for (int r = 0; r < rounds; ++r) {
+        uint64_t s = ticks();
+        for (int i = 0; i < count; ++i) reference(subpages[i], ref_frame);
+        t_ref += ticks() - s;
+        s = ticks();
+        for (int i = 0; i < count; ++i) {
+            M5_Thermal2_FrameAssembler::merge(subpages[i], lib_frame);
+        }
+        t_lib += ticks() - s;
+    }
+    double n = (double)count * rounds;
+#if HAVE_RDTSC
+    const char* unit = "TSC cycles";
+#else
+    const char* unit = "ns";
+#endif
+    printf("frame assembler (identical output to reference: yes)\n");
+    printf("  reference (SmoothDraw) : %8.0f %s/frame\n", t_ref / n, unit);
+    printf("  library                : %8.0f %s/frame  (x%.2f)\n", t_lib / n,
+           unit, (double)t_ref / t_lib);
+    return 0;
+}
@@ -0,0 +1,109 @@
+// Host benchmark of M5_Thermal2_BackgroundModel.
+//
+// The simulator's scene at 32 Hz: the static gradient for the first third of
+// the run (the model learns it), then with the orbiting hot spot. Reported
+// per phase: foreground pixels where the scene is background (false
+// positives, per subpage), the hot spot pixels found (recall; truth: the
+// scene is 2 degC or more above the gradient), the motion score and the cost
+// of update(). Run once with every subpage processed and once with the
+// static skip on most_diff_raw.
+
+#include <Wire.h>
+
+#include "M5_Thermal2.h"
+#include "M5_Thermal2_BackgroundModel.h"
+#include "M5_Thermal2_Simulator.h"
+#include "bench_util.h"
+
+typedef M5_Thermal2::temperature_data_t temperature_data_t;
+
+static constexpr int width  = M5_Thermal2::frame_width;
+static constexpr int height = M5_Thermal2::frame_height;
+
+static uint16_t gradient[width * height];
+
+struct phase_t {
+    uint32_t subpages;
+    uint32_t processed;
+    uint32_t false_positives;
+    uint32_t truth;
+    uint32_t found;
+    uint32_t motion;
+    double update_ns;
+};
+
+static void report(const char* name, const phase_t& p) {
+    printf("  %-7s %5u subpages (%5u processed)  false positives %6.2f  ",
+           name, p.subpages, p.processed,
+           (double)p.false_positives / p.subpages);
+    if (p.truth) {
+        printf("recall %5.1f %%  ", 100.0 * p.found / p.truth);
+    } else {
+        printf("recall     -    ");
+    }
+    printf("motion %5.1f  update %5.0f ns\n", (double)p.motion / p.subpages,
+           p.processed ? p.update_ns / p.processed : 0.0);
+}
+
+static void run(uint16_t noise, uint32_t seconds, uint16_t skip_raw) {
+    bench_unit_t unit(M5_Thermal2::rate_32Hz);
+    unit.sim.setNoise(noise);
+    unit.sim.setHotSpot(false);
+    unit.thermal2.setNoiseFilterLevel(0);
+
+    M5_Thermal2_BackgroundModel model;
+    model.setStaticSkip(skip_raw);
+    temperature_data_t data;
+    phase_t phase[2]     = {};
+    uint32_t start       = micros();
+    const uint32_t learn = seconds / 3 * 1000000u;
+    printf("noise %2u, static skip %s\n", noise, skip_raw ? "on" : "off");
+    while (micros() - start < seconds * 1000000u) {
+        bool moving = micros() - start >= learn;
+        unit.sim.setHotSpot(moving);
+        unit.next(data);
+        double t0      = nowNs();
+        bool processed = model.update(data);
+        double t1      = nowNs();
+        if (!model.isReady()) continue;
+
+        phase_t& p = phase[moving];
+        ++p.subpages;
+        if (processed) {
+            ++p.processed;
+            p.update_ns += t1 - t0;
+        }
+        p.motion += model.getMotionScore();
+        const uint16_t* scene = unit.sim.getScene();
+        for (int i = 0; i < M5_Thermal2::subpage_pixels; ++i) {
+            int y       = i >> 4;
+            int x       = ((i & 15) << 1) + ((y & 1) != data.subpage);
+            int above   = scene[x + y * width] - gradient[x + y * width];
+            bool fg     = model.isForeground(x, y);
+            bool inside = above >= 2 * 128;
+            if (inside) {
+                ++p.truth;
+                p.found += fg;
+            } else if (fg && above < 4 * noise) {
+                ++p.false_positives;
+            }
+        }
+    }
+    report("static", phase[0]);
+    report("moving", phase[1]);
+}
+
+int main(int argc, char** argv) {
+    uint16_t noise   = (argc > 1) ? atoi(argv[1]) : 24;
+    uint32_t seconds = (argc > 2) ? atoi(argv[2]) : 60;
+
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            gradient[x + y * width] =
+                M5_Thermal2::convertCelsiusToRaw(22.0f + x * 0.10f + y * 0.05f);
+        }
+    }
+    run(noise, seconds, 0);
+    run(noise, seconds, noise * 4);
+    return 0;
+}
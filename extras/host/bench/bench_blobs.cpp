@@ -0,0 +1,219 @@
+// Host benchmark of M5_Thermal2_BlobTracker.
+//
+//  - correctness: random frames, each region (area, peak, bounding box)
+//    against a flood fill reference
+//  - cost: typical frame, and patterns built for the worst case of each
+//    stage (most provisional labels, most unions, most blobs to track)
+//  - tracking: several hot spots moving on a noisy background, counting
+//    how often a spot's id changes
+// Cost is reported in ns on the host; the stage counts in the header of
+// M5_Thermal2_BlobTracker.h do not depend on the scene.
+
+#include <Wire.h>
+#include <math.h>
+
+#include "M5_Thermal2.h"
+#include "M5_Thermal2_BlobTracker.h"
+#include "bench_util.h"
+
+static constexpr int width     = M5_Thermal2::frame_width;
+static constexpr int height    = M5_Thermal2::frame_height;
+static constexpr uint16_t cold = 22 * 128 + 64 * 128;
+static constexpr uint16_t hot  = 40 * 128 + 64 * 128;
+
+typedef M5_Thermal2_BlobTracker::blob_t blob_t;
+
+static uint32_t lcg = 12345;
+static uint32_t rnd(void) {
+    lcg = lcg * 1664525u + 1013904223u;
+    return lcg >> 8;
+}
+
+// 8-connected flood fill. Returns the number of regions, fills dst.
+static int reference(const uint16_t* frame, uint16_t threshold, blob_t* dst,
+                     int max) {
+    static uint8_t seen[width * height];
+    static uint16_t stack[width * height];
+    memset(seen, 0, sizeof(seen));
+    int regions = 0;
+    for (int i = 0; i < width * height; ++i) {
+        if (seen[i] || frame[i] < threshold) continue;
+        blob_t b = {};
+        b.left = b.right = i % width;
+        b.top = b.bottom = i / width;
+        int sp      = 0;
+        stack[sp++] = i;
+        seen[i]     = 1;
+        while (sp) {
+            int p = stack[--sp];
+            int x = p % width, y = p / width;
+            ++b.area;
+            if (b.peak_raw < frame[p]) b.peak_raw = frame[p];
+            if (b.left > x) b.left = x;
+            if (b.right < x) b.right = x;
+            if (b.top > y) b.top = y;
+            if (b.bottom < y) b.bottom = y;
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    int nx = x + dx, ny = y + dy;
+                    if (nx < 0 || ny < 0 || nx >= width || ny >= height) {
+                        continue;
+                    }
+                    int q = nx + ny * width;
+                    if (seen[q] || frame[q] < threshold) continue;
+                    seen[q]     = 1;
+                    stack[sp++] = q;
+                }
+            }
+        }
+        if (regions < max) dst[regions] = b;
+        ++regions;
+    }
+    return regions;
+}
+
+static bool sameRegion(const blob_t& a, const blob_t& b) {
+    return a.area == b.area && a.peak_raw == b.peak_raw && a.left == b.left &&
+           a.right == b.right && a.top == b.top && a.bottom == b.bottom;
+}
+
+static void checkRandom(int frames) {
+    static uint16_t frame[width * height];
+    static blob_t ref[width * height];
+    M5_Thermal2_BlobTracker tracker;
+    tracker.setThreshold(hot);
+    int errors = 0;
+    for (int f = 0; f < frames; ++f) {
+        int density = 20 + f % 60;  // percent hot
+        for (auto& v : frame) {
+            v = (int)(rnd() % 100) < density ? hot + rnd() % 512
+                                              : cold + rnd() % 512;
+        }
+        int regions = reference(frame, hot, ref, width * height);
+        tracker.update(frame);
+        if (regions != tracker.getRegionCount()) {
+            ++errors;
+            continue;
+        }
+        // Every reported blob must be one of the reference regions, and
+        // no larger region may have been left out.
+        uint16_t smallest = UINT16_MAX;
+        for (int b = 0; b < tracker.getBlobCount(); ++b) {
+            auto& blob = tracker.getBlob(b);
+            bool found = false;
+            for (int r = 0; r < regions && !found; ++r) {
+                found = sameRegion(blob, ref[r]);
+            }
+            errors += !found;
+            if (smallest > blob.area) smallest = blob.area;
+        }
+        int larger = 0;
+        for (int r = 0; r < regions; ++r) larger += ref[r].area > smallest;
+        errors += larger > tracker.getBlobCount();
+    }
+    printf("random frames %d, mismatches %d\n", frames, errors);
+}
+
+static void timing(const char* name, const uint16_t* frame, int iterations) {
+    M5_Thermal2_BlobTracker tracker;
+    tracker.setThreshold(hot);
+    tracker.update(frame);
+    double t = nowNs();
+    for (int i = 0; i < iterations; ++i) tracker.update(frame);
+    t = (nowNs() - t) / iterations;
+    printf("%-32s %4u regions %2u blobs  %7.0f ns/frame\n", name,
+           tracker.getRegionCount(), tracker.getBlobCount(), t);
+}
+
+static void costs(int iterations) {
+    static uint16_t frame[width * height];
+    // One spot, as the simulator's scene.
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int d2               = (x - 12) * (x - 12) + (y - 9) * (y - 9);
+            frame[x + y * width] = (d2 < 12) ? hot + 256 : cold;
+        }
+    }
+    timing("one spot", frame, iterations);
+
+    // Isolated pixels two apart: most provisional labels and regions.
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            frame[x + y * width] = (!(x & 1) && !(y & 1)) ? hot : cold;
+        }
+    }
+    timing("isolated pixels (max regions)", frame, iterations);
+
+    // Columns joined on every other row by an NE diagonal: a label per
+    // column, merged one by one (most unions).
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            bool on              = !(x & 1) || (y & 1);
+            frame[x + y * width] = on ? hot : cold;
+        }
+    }
+    timing("combs (max unions)", frame, iterations);
+
+    // Every hot pixel.
+    for (auto& v : frame) v = hot;
+    timing("all hot", frame, iterations);
+
+    // 48 separate 2x2 squares: a full blob list to match every frame.
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            frame[x + y * width] = ((x % 4) < 2 && (y % 4) < 2) ? hot : cold;
+        }
+    }
+    timing("2x2 squares (max tracking)", frame, iterations);
+}
+
+static void tracking(int frames, int spots) {
+    static uint16_t frame[width * height];
+    M5_Thermal2_BlobTracker tracker;
+    tracker.setThreshold(hot);
+    tracker.setMinArea(2);
+    uint16_t last_id[8] = {};
+    int switches = 0, lost = 0;
+    for (int f = 0; f < frames; ++f) {
+        float sx[8], sy[8];
+        for (int s = 0; s < spots; ++s) {
+            float t = f * 0.02f + s * 2.0f;
+            sx[s]   = 4.0f + s * 8.0f + 1.0f * cosf(t);
+            sy[s]   = 11.5f + 9.0f * sinf(t * 0.7f);
+        }
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                int v = cold + rnd() % 256;
+                for (int s = 0; s < spots; ++s) {
+                    float d2 = (x - sx[s]) * (x - sx[s]) +
+                               (y - sy[s]) * (y - sy[s]);
+                    if (d2 < 6.0f) v = hot + 128 + rnd() % 256;
+                }
+                frame[x + y * width] = v;
+            }
+        }
+        tracker.update(frame);
+        for (int s = 0; s < spots; ++s) {
+            int b = tracker.getBlobIndex((int)(sx[s] + 0.5f),
+                                         (int)(sy[s] + 0.5f));
+            if (b < 0) {
+                ++lost;
+                continue;
+            }
+            uint16_t id = tracker.getBlob(b).id;
+            if (f && last_id[s] != id) ++switches;
+            last_id[s] = id;
+        }
+    }
+    printf("tracking %d spots over %d frames: %d id changes, %d misses\n",
+           spots, frames, switches, lost);
+}
+
+int main(int argc, char** argv) {
+    int iterations = (argc > 1) ? atoi(argv[1]) : 20000;
+
+    checkRandom(2000);
+    costs(iterations);
+    tracking(2000, 4);
+    return 0;
+}
@@ -0,0 +1,145 @@
+// Host benchmark of the capture stream (M5_Thermal2_Capture.h).
+//
+// Subpages are recorded from the simulated unit at 64Hz, once with the
+// moving hot spot and no noise and once as a static scene with the given
+// noise. Each set is encoded into memory, decoded and compared pixel for
+// pixel. Reported: bytes per subpage, ratio against the 768 byte pixel
+// stream, and encode / decode throughput in raw pixel MB/s. The replay is
+// checked to return the subpages at their recorded pace.
+
+#include <Wire.h>
+#include <vector>
+
+#include "M5_Thermal2.h"
+#include "M5_Thermal2_Capture.h"
+#include "M5_Thermal2_Simulator.h"
+#include "bench_util.h"
+
+typedef M5_Thermal2::temperature_data_t temperature_data_t;
+
+static constexpr int subpages = 1024;
+
+static temperature_data_t source[subpages];
+static uint32_t stamp[subpages];
+
+/// Print / Stream on a growing buffer.
+class MemoryStream : public Stream {
+   public:
+    std::vector<uint8_t> data;
+    size_t pos = 0;
+
+    size_t write(uint8_t c) override {
+        data.push_back(c);
+        return 1;
+    }
+    size_t write(const uint8_t* buffer, size_t size) override {
+        data.insert(data.end(), buffer, buffer + size);
+        return size;
+    }
+    int available(void) override {
+        return data.size() - pos;
+    }
+    int read(void) override {
+        return (pos < data.size()) ? data[pos++] : -1;
+    }
+    int peek(void) override {
+        return (pos < data.size()) ? data[pos] : -1;
+    }
+    size_t readBytes(uint8_t* buffer, size_t length) override {
+        if (length > data.size() - pos) length = data.size() - pos;
+        memcpy(buffer, &data[pos], length);
+        pos += length;
+        return length;
+    }
+    using Stream::readBytes;
+};
+
+static void record(uint16_t noise, bool hot_spot) {
+    bench_unit_t unit(M5_Thermal2::rate_64Hz);
+    unit.sim.setNoise(noise);
+    unit.sim.setHotSpot(hot_spot);
+    for (int n = 0; n < subpages; ++n) {
+        unit.next();
+        source[n] = unit.thermal2.getTemperatureData();
+        stamp[n]  = micros();
+    }
+}
+
+static bool same(const temperature_data_t& a, const temperature_data_t& b) {
+    return a.subpage == b.subpage &&
+           !memcmp(a.pixel_raw, b.pixel_raw, sizeof(a.pixel_raw)) &&
+           !memcmp(&a.temperature_reg, &b.temperature_reg,
+                   sizeof(a.temperature_reg));
+}
+
+static void run(const char* name, uint16_t key_interval) {
+    MemoryStream stream;
+    M5_Thermal2_CaptureEncoder encoder;
+    encoder.setKeyInterval(key_interval);
+    double t = nowNs();
+    encoder.begin(&stream);
+    for (int n = 0; n < subpages; ++n) encoder.write(source[n], stamp[n]);
+    double encode_ns = nowNs() - t;
+
+    M5_Thermal2_CaptureDecoder decoder;
+    static temperature_data_t decoded[subpages];
+    static uint32_t decoded_usec[subpages];
+    t = nowNs();
+    decoder.begin(&stream);
+    int count = 0;
+    while (count < subpages &&
+           decoder.read(decoded[count], &decoded_usec[count])) {
+        ++count;
+    }
+    double decode_ns = nowNs() - t;
+
+    int mismatch = subpages - count;
+    for (int n = 0; n < count; ++n) {
+        if (!same(source[n], decoded[n]) || decoded_usec[n] != stamp[n]) {
+            ++mismatch;
+        }
+    }
+    double per_subpage = (double)stream.data.size() / subpages;
+    double mb          = subpages * M5_Thermal2_Capture::raw_size / 1e6;
+    printf(
+        "%-18s key %3u  %7.1f bytes/subpage  ratio %5.2f  encode %7.1f MB/s  "
+        "decode %7.1f MB/s  mismatches %d\n",
+        name, key_interval, per_subpage, 768 / per_subpage,
+        mb / (encode_ns / 1e9), mb / (decode_ns / 1e9), mismatch);
+}
+
+static void replay(void) {
+    MemoryStream stream;
+    M5_Thermal2_CaptureEncoder encoder;
+    encoder.begin(&stream);
+    for (int n = 0; n < subpages; ++n) encoder.write(source[n], stamp[n]);
+
+    M5_Thermal2_Replay player;
+    player.begin(&stream);
+    uint32_t start    = micros();
+    int count         = 0;
+    int32_t worst_lag = 0;
+    while (!player.isEnd()) {
+        player.waitForFrame();
+        if (!player.update()) continue;
+        int32_t lag = (int32_t)(micros() - start) -
+                      (int32_t)(player.getRecordedMicros() - stamp[0]);
+        if (worst_lag < abs(lag)) worst_lag = abs(lag);
+        count += same(source[count], player.getTemperatureData());
+    }
+    printf("replay %d / %d subpages match, pace error max %d us\n", count,
+           subpages, worst_lag);
+}
+
+int main(int argc, char** argv) {
+    uint16_t noise = (argc > 1) ? atoi(argv[1]) : 16;
+
+    record(0, true);
+    run("hot spot", 64);
+    run("hot spot", 0);
+    replay();
+    record(noise, false);
+    run("static + noise", 64);
+    run("static + noise", 0);
+    return 0;
+}
@@ -0,0 +1,137 @@
+// Host benchmark of M5_Thermal2_TemporalFilter.
+//
+// The unit runs at 64Hz with its own noise filter at level 0, the host
+// filters the subpages. Reported:
+//  - cost per subpage, against the 64Hz subpage period
+//  - noise of a static scene (RMS deviation from the per-pixel mean)
+//  - error on a moving hot spot without noise (mean absolute difference
+//    from the simulator's scene), showing the lag of the filter
+// The adaptive gain is compared with a plain IIR of the same strength.
+
+#include <Wire.h>
+#include <math.h>
+
+#include "M5_Thermal2.h"
+#include "M5_Thermal2_Simulator.h"
+#include "M5_Thermal2_TemporalFilter.h"
+#include "bench_util.h"
+
+typedef M5_Thermal2::temperature_data_t temperature_data_t;
+
+static constexpr int frame_width    = M5_Thermal2::frame_width;
+static constexpr int subpage_pixels = M5_Thermal2::subpage_pixels;
+static constexpr int subpages       = 512;
+
+static temperature_data_t noisy[subpages];
+static temperature_data_t moving[subpages];
+static const uint16_t* truth[subpages];
+static uint16_t truth_store[subpages][subpage_pixels];
+
+static void capture(temperature_data_t* dst, bool keep_truth) {
+    bench_unit_t unit(M5_Thermal2::rate_64Hz);
+    unit.sim.setNoise(keep_truth ? 0 : 48);
+    unit.sim.setHotSpot(keep_truth);
+    unit.thermal2.setNoiseFilterLevel(0);
+    for (int n = 0; n < subpages; ++n) {
+        unit.next();
+        auto& data = unit.thermal2.getTemperatureData();
+        dst[n]     = data;
+        if (keep_truth) {
+            // Scene pixels of this subpage, in subpage order.
+            for (int i = 0; i < subpage_pixels; ++i) {
+                int y = i >> 4;
+                int x = ((i & 15) << 1) + ((y & 1) != data.subpage);
+                truth_store[n][i] = unit.sim.getScene()[x + y * frame_width];
+            }
+            truth[n] = truth_store[n];
+        }
+    }
+}
+
+// Noise (static) or error (moving) of a filtered sequence.
+static double measure(temperature_data_t* seq, M5_Thermal2_TemporalFilter* f,
+                      bool moving_scene) {
+    static double sum[2][subpage_pixels], sum2[2][subpage_pixels];
+    static int count[2];
+    memset(sum, 0, sizeof(sum));
+    memset(sum2, 0, sizeof(sum2));
+    count[0] = count[1] = 0;
+    double err = 0;
+    int err_n  = 0;
+    if (f) f->reset();
+    for (int n = 0; n < subpages; ++n) {
+        temperature_data_t data = seq[n];
+        if (f) f->filter(data);
+        if (n < 64) continue;  // settle
+        int sp = data.subpage;
+        ++count[sp];
+        for (int i = 0; i < subpage_pixels; ++i) {
+            double v = data.pixel_raw[i];
+            if (moving_scene) {
+                err += fabs(v - truth[n][i]);
+                ++err_n;
+            } else {
+                sum[sp][i] += v;
+                sum2[sp][i] += v * v;
+            }
+        }
+    }
+    if (moving_scene) return err / err_n;
+    double var = 0;
+    for (int sp = 0; sp < 2; ++sp) {
+        for (int i = 0; i < subpage_pixels; ++i) {
+            double m = sum[sp][i] / count[sp];
+            var += sum2[sp][i] / count[sp] - m * m;
+        }
+    }
+    return sqrt(var / (2 * subpage_pixels));
+}
+
+int main(int argc, char** argv) {
+    uint8_t strength   = (argc > 1) ? atoi(argv[1]) : 3;
+    uint16_t noise_raw = (argc > 2) ? atoi(argv[2]) : 48;
+
+    capture(noisy, false);
+    capture(moving, true);
+
+    M5_Thermal2_TemporalFilter adaptive;
+    adaptive.setParam(strength, noise_raw);
+    // Plain IIR: the motion ramp starts beyond the LUT.
+    M5_Thermal2_TemporalFilter plain;
+    plain.setParam(strength, 1020);
+
+    // Cost per subpage.
+    volatile uint32_t sink = 0;
+    int iterations         = 200;
+    double t0              = nowNs();
+    for (int it = 0; it < iterations; ++it) {
+        for (int n = 0; n < subpages; ++n) {
+            temperature_data_t data = noisy[n];
+            sink += adaptive.filter(data);
+        }
+    }
+    double t1 = nowNs();
+    for (int it = 0; it < iterations; ++it) {
+        for (int n = 0; n < subpages; ++n) {
+            temperature_data_t data = noisy[n];
+            sink += data.pixel_raw[n % subpage_pixels];
+        }
+    }
+    double t2        = nowNs();
+    double n         = (double)iterations * subpages;
+    double cost_ns   = ((t1 - t0) - (t2 - t1)) / n;
+    double period_ns = 1e9 / 64;
+
+    printf("strength %u, noise %u raw (%.2f C)\n", strength, noise_raw,
+           noise_raw / 128.0);
+    printf("cost %.0f ns per subpage (%.4f%% of the 64Hz subpage period)\n",
+           cost_ns, cost_ns * 100 / period_ns);
+    printf("%-10s %18s %22s\n", "", "static noise RMS", "moving spot err avg");
+    printf("%-10s %14.2f raw %18.2f raw\n", "none", measure(noisy, nullptr, 0),
+           measure(moving, nullptr, 1));
+    printf("%-10s %14.2f raw %18.2f raw\n", "plain", measure(noisy, &plain, 0),
+           measure(moving, &plain, 1));
+    printf("%-10s %14.2f raw %18.2f raw\n", "adaptive",
+           measure(noisy, &adaptive, 0), measure(moving, &adaptive, 1));
+    return sink == 0xFFFFFFFFu;
+}
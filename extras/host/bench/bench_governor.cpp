@@ -0,0 +1,75 @@
+// Host benchmark of M5_Thermal2_ClockGovernor.
+//
+// The simulated cable is clean up to 600kHz and produces pixel read errors
+// above it. For each refresh rate the governor starts at 1MHz and should
+// settle on the lowest clock that sustains the rate without errors. Run with
+// a 100kHz base clock, and with the 400kHz of the examples, below which the
+// pixel read cannot go.
+
+#include <Wire.h>
+
+#include "M5_Thermal2.h"
+#include "M5_Thermal2_ClockGovernor.h"
+#include "M5_Thermal2_Simulator.h"
+#include "bench_util.h"
+
+static uint32_t cableErrorPpm(uint32_t freq) {
+    if (freq <= 600000) return 0;
+    if (freq <= 800000) return 30000;
+    return 200000;
+}
+
+static const char* const reason_name[] = {"start", "failure", "too slow",
+                                          "headroom", "rate"};
+
+static void run(uint32_t base, M5_Thermal2::refresh_rate_t rate,
+                uint32_t seconds) {
+    bench_unit_t unit(rate, base);
+    M5_Thermal2_ClockGovernor governor;
+    governor.begin(&unit.thermal2);
+
+    uint32_t ok = 0, changes = 0;
+    uint32_t generated0 = unit.sim.getFramesGenerated();
+    uint32_t missed0    = unit.sim.getFramesMissed();
+    uint64_t end_us     = hostMicros64() + seconds * 1000000ull;
+    while (hostMicros64() < end_us) {
+        unit.sim.setPixelReadErrorRate(
+            cableErrorPpm(unit.thermal2.getI2CFreqPixelRead()));
+        bool result = unit.thermal2.update();
+        changes += governor.update(result);
+        if (result) {
+            ++ok;
+        } else {
+            delay(1);
+        }
+    }
+    printf(
+        "rate %d (%4.1f Hz)  final %7u Hz  ceiling %7u Hz  changes %u  "
+        "frames %u / %u  missed %u  dropped chunks %u\n",
+        rate, 1000000.0 / unit.sim.getFramePeriodMicros(), governor.getFreq(),
+        governor.getCeilingFreq(), changes, ok,
+        unit.sim.getFramesGenerated() - generated0,
+        unit.sim.getFramesMissed() - missed0,
+        unit.thermal2.getChunkDroppedCount());
+    for (size_t i = governor.getHistoryCount(); i--;) {
+        auto d = governor.getHistory(i);
+        printf("    %7u ms  %7u Hz  %-8s  pixel read %5u us\n", d->msec,
+               d->freq, reason_name[d->reason], d->pixel_read_usec);
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t seconds = (argc > 1) ? atoi(argv[1]) : 30;
+
+    static const M5_Thermal2::refresh_rate_t rates[] = {
+        M5_Thermal2::rate_8Hz, M5_Thermal2::rate_16Hz, M5_Thermal2::rate_32Hz,
+        M5_Thermal2::rate_64Hz};
+    static const uint32_t bases[] = {100000, 400000};
+    for (auto base : bases) {
+        printf("base clock %u Hz\n", base);
+        for (auto rate : rates) {
+            run(base, rate, seconds);
+        }
+    }
+    return 0;
+}
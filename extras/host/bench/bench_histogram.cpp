@@ -0,0 +1,144 @@
+// Host benchmark of M5_Thermal2_Histogram.
+//
+// Per frame work of a display: a histogram of the display range, robust
+// 1% / 99% limits and the lowest / highest value. The reference does this
+// the way SmoothDraw's hist_ui_t does (multiply and divide per pixel) plus
+// a copy and nth_element per percentile. The library does one counting
+// pass. Also reported: the percentile error, and the empty slices of a
+// narrow display range, where a slice is smaller than a raw value.
+
+#include <Wire.h>
+#include <algorithm>
+
+#include "M5_Thermal2.h"
+#include "M5_Thermal2_Histogram.h"
+#include "M5_Thermal2_Simulator.h"
+#include "bench_util.h"
+
+static constexpr int pixels      = 768;
+static constexpr int frames      = 64;
+static constexpr int hist_height = 200;
+
+static uint16_t scene[frames][pixels];
+
+static uint16_t exactPercentile(const uint16_t* src, float percent) {
+    static uint16_t work[pixels];
+    memcpy(work, src, sizeof(work));
+    size_t k = (size_t)(percent / 100.0f * pixels);
+    if (k >= pixels) k = pixels - 1;
+    std::nth_element(work, work + k, work + pixels);
+    return work[k];
+}
+
+int main(int argc, char** argv) {
+    int iterations = (argc > 1) ? atoi(argv[1]) : 200;
+
+    bench_unit_t unit(M5_Thermal2::rate_8Hz, 400000, 400000);
+    for (int f = 0; f < frames; ++f) {
+        unit.next();
+        memcpy(scene[f], unit.sim.getScene(), sizeof(scene[0]));
+    }
+
+    static uint16_t hist[hist_height];
+    volatile uint32_t sink = 0;
+
+    // Reference.
+    double t0 = nowNs();
+    for (int it = 0; it < iterations; ++it) {
+        for (int f = 0; f < frames; ++f) {
+            const uint16_t* src = scene[f];
+            int32_t lowest = INT32_MAX, highest = INT32_MIN;
+            for (int i = 0; i < pixels; ++i) {
+                lowest  = std::min<int32_t>(lowest, src[i]);
+                highest = std::max<int32_t>(highest, src[i]);
+            }
+            int32_t p1   = exactPercentile(src, 1.0f);
+            int32_t p99  = exactPercentile(src, 99.0f);
+            int32_t diff = p99 - p1 + 1;
+            memset(hist, 0, sizeof(hist));
+            int hist_max = hist_height - 1;
+            for (int i = 0; i < pixels; ++i) {
+                int idx = (src[i] - p1) * hist_height / diff;
+                ++hist[(idx < 0) ? 0 : ((idx > hist_max) ? hist_max : idx)];
+            }
+            sink += lowest + highest + hist[hist_height >> 1];
+        }
+    }
+    double t1 = nowNs();
+
+    // Library.
+    M5_Thermal2_Histogram histogram;
+    static uint8_t lut[M5_Thermal2_Histogram::lut_size];
+    for (int it = 0; it < iterations; ++it) {
+        for (int f = 0; f < frames; ++f) {
+            histogram.update(scene[f], pixels);
+            int32_t p1  = histogram.getPercentile(1.0f);
+            int32_t p99 = histogram.getPercentile(99.0f);
+            histogram.getHistogram(p1, p99, hist, hist_height);
+            sink += histogram.getLowest() + histogram.getHighest() +
+                    hist[hist_height >> 1];
+        }
+    }
+    double t2 = nowNs();
+    for (int it = 0; it < iterations; ++it) {
+        for (int f = 0; f < frames; ++f) {
+            histogram.update(scene[f], pixels);
+            histogram.getEqualizationLut(histogram.getLowest(),
+                                         histogram.getHighest(), lut);
+            sink += lut[128];
+        }
+    }
+    double t3 = nowNs();
+
+    // Accuracy of the percentiles against a full sort.
+    int err_max = 0;
+    for (int f = 0; f < frames; ++f) {
+        histogram.update(scene[f], pixels);
+        static const float ps[] = {1.0f, 5.0f, 50.0f, 95.0f, 99.0f};
+        for (float p : ps) {
+            int e = abs((int)histogram.getPercentile(p) -
+                        (int)exactPercentile(scene[f], p));
+            if (err_max < e) err_max = e;
+        }
+    }
+
+    // A narrow display range (1 degree Celsius over the slices, below a bin
+    // per slice): empty slices between the first and the last non-empty
+    // one, with per-pixel binning and from the library.
+    int gaps_ref = 0, gaps_lib = 0;
+    for (int f = 0; f < frames; ++f) {
+        histogram.update(scene[f], pixels);
+        int32_t low = histogram.getPercentile(50.0f) - 64;
+        static uint16_t ref[hist_height];
+        memset(ref, 0, sizeof(ref));
+        for (int i = 0; i < pixels; ++i) {
+            int idx = (scene[f][i] - low) * hist_height / 128;
+            if (idx >= 0 && idx < hist_height) ++ref[idx];
+        }
+        histogram.getHistogram(low, low + 127, hist, hist_height);
+        for (auto h : {ref, hist}) {
+            // The library's first and last slices hold the values outside.
+            int first = 1, last = hist_height - 2;
+            while (first < last && h[first] == 0) ++first;
+            while (last > first && h[last] == 0) --last;
+            int gaps = 0;
+            for (int i = first; i < last; ++i) gaps += (h[i] == 0);
+            ((h == ref) ? gaps_ref : gaps_lib) += gaps;
+        }
+    }
+
+    double n = (double)iterations * frames;
+    printf("%-52s %7.0f ns/frame\n",
+           "reference (scan, 2 x nth_element, div histogram)", (t1 - t0) / n);
+    printf("%-52s %7.0f ns/frame  (x%.2f)\n",
+           "library (update, 2 x percentile, histogram)", (t2 - t1) / n,
+           (t1 - t0) / (t2 - t1));
+    printf("%-52s %7.0f ns/frame\n", "library (update, equalisation LUT)",
+           (t3 - t2) / n);
+    printf("percentile error max %d raw (%.3f C, bin %d raw)\n", err_max,
+           err_max / 128.0, 1 << M5_Thermal2_Histogram::bin_shift);
+    printf("1 C over %d slices, empty slices inside: per-pixel %.1f, "
+           "library %.1f\n",
+           hist_height, (double)gaps_ref / frames, (double)gaps_lib / frames);
+    return sink == 0xFFFFFFFFu;
+}
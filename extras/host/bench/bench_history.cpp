@@ -0,0 +1,105 @@
+// Host benchmark of M5_Thermal2_History.
+//
+// Subpages from the simulator (moving hot spot, with the given noise) are
+// appended to a 96 KB history, with several key intervals. Every retained
+// subpage is read back in random order and compared with what was appended.
+// Reported: bytes per subpage (against sizeof(temperature_data_t)), retained
+// seconds at 32 Hz, and the cost of append, random read and playback read.
+
+#include <Wire.h>
+
+#include "M5_Thermal2.h"
+#include "M5_Thermal2_History.h"
+#include "M5_Thermal2_Simulator.h"
+#include "bench_util.h"
+
+typedef M5_Thermal2::temperature_data_t temperature_data_t;
+
+static constexpr int subpages     = 2048;
+static constexpr size_t buffer_kb = 96;
+
+static temperature_data_t source[subpages];
+static uint8_t buffer[buffer_kb * 1024];
+
+static uint32_t lcg = 12345;
+static uint32_t rnd(void) {
+    lcg = lcg * 1664525u + 1013904223u;
+    return lcg >> 8;
+}
+
+static void record(uint16_t noise) {
+    bench_unit_t unit(M5_Thermal2::rate_32Hz);
+    unit.sim.setNoise(noise);
+    unit.thermal2.setNoiseFilterLevel(0);
+    for (int n = 0; n < subpages; ++n) {
+        unit.next();
+        source[n] = unit.thermal2.getTemperatureData();
+    }
+}
+
+static bool same(const temperature_data_t& a, const temperature_data_t& b) {
+    return a.subpage == b.subpage && a.stale_rows == b.stale_rows &&
+           !memcmp(a.pixel_raw, b.pixel_raw, sizeof(a.pixel_raw)) &&
+           !memcmp(&a.temperature_reg, &b.temperature_reg,
+                   sizeof(a.temperature_reg));
+}
+
+static void run(uint16_t noise, uint16_t interval) {
+    M5_Thermal2_History history;
+    history.begin(buffer, sizeof(buffer), 2048);
+    history.setKeyInterval(interval);
+
+    double append_ns = 0;
+    for (int n = 0; n < subpages; ++n) {
+        double t0 = nowNs();
+        history.append(source[n], n * 31250u);
+        append_ns += nowNs() - t0;
+    }
+
+    // Random order, every retained subpage once.
+    static uint32_t order[subpages];
+    uint32_t count = history.size();
+    for (uint32_t i = 0; i < count; ++i) order[i] = i;
+    for (uint32_t i = count - 1; i > 0; --i) {
+        uint32_t j = rnd() % (i + 1);
+        uint32_t t = order[i];
+        order[i]   = order[j];
+        order[j]   = t;
+    }
+    temperature_data_t dst;
+    int mismatch     = 0;
+    double random_ns = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t usec;
+        double t0 = nowNs();
+        history.read(order[i], dst, &usec);
+        random_ns += nowNs() - t0;
+        uint32_t n = subpages - 1 - order[i];
+        mismatch += !same(dst, source[n]) || usec != n * 31250u;
+    }
+    // Playback, oldest to newest.
+    double play_ns = nowNs();
+    for (uint32_t age = count; age-- > 0;) {
+        history.read(age, dst);
+        mismatch += !same(dst, source[subpages - 1 - age]);
+    }
+    play_ns = nowNs() - play_ns;
+
+    printf(
+        "noise %2u key interval %3u  %6.1f bytes/subpage (%u)  %4u retained "
+        "(%4.1f s)  append %6.0f ns  read %7.0f ns  playback %6.0f ns  "
+        "mismatches %d\n",
+        noise, interval, history.getBytesPerFrame(),
+        (unsigned)sizeof(temperature_data_t), count, count / 32.0,
+        append_ns / subpages, random_ns / count, play_ns / count, mismatch);
+}
+
+int main(int argc, char** argv) {
+    uint16_t noise = (argc > 1) ? atoi(argv[1]) : 24;
+
+    for (uint16_t n : {(uint16_t)0, (uint16_t)8, noise}) {
+        record(n);
+        for (uint16_t interval : {16, 64, 256}) run(n, interval);
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+// Host benchmark of M5_Thermal2_NonUniformity.
+//
+// A fixed pattern (uniform random offsets, +-64 raw, per subpage and pixel)
+// is added to every subpage, as a sensor with residual offsets would show.
+//  - flat field: uniform subpages with noise, captured over 64 subpages per
+//    parity; the table is also saved and restored as int8.
+//  - shutterless: the simulator's scene (gradient and a moving hot spot,
+//    with the given noise) at 32 Hz, estimator only.
+// Reported: the pattern left after correction (RMS, raw, its mean removed),
+// the error against the scene, and the cost of apply() and update().
+
+#include <Wire.h>
+#include <math.h>
+
+#include "M5_Thermal2.h"
+#include "M5_Thermal2_NonUniformity.h"
+#include "M5_Thermal2_Simulator.h"
+#include "bench_util.h"
+
+typedef M5_Thermal2::temperature_data_t temperature_data_t;
+typedef M5_Thermal2_NonUniformity nuc_t;
+
+static constexpr int pixels = nuc_t::pixel_count;
+
+static int16_t pattern[2][pixels];
+
+static uint32_t lcg = 12345;
+static uint32_t rnd(void) {
+    lcg = lcg * 1664525u + 1013904223u;
+    return lcg >> 8;
+}
+
+// RMS of pattern + offset, its mean removed.
+static double residual(const nuc_t& nuc) {
+    double sum = 0, sum2 = 0;
+    for (int sp = 0; sp < 2; ++sp) {
+        for (int i = 0; i < pixels; ++i) {
+            double r = pattern[sp][i] + nuc.getOffset(sp, i);
+            sum += r;
+            sum2 += r * r;
+        }
+    }
+    double mean = sum / (2 * pixels);
+    return sqrt(sum2 / (2 * pixels) - mean * mean);
+}
+
+static void flatField(uint16_t noise) {
+    nuc_t nuc;
+    temperature_data_t data = {};
+    uint16_t level          = M5_Thermal2::convertCelsiusToRaw(25);
+    nuc.beginFlatField(64);
+    int subpages = 0;
+    while (nuc.isCapturing()) {
+        data.subpage = subpages++ & 1;
+        for (int i = 0; i < pixels; ++i) {
+            data.pixel_raw[i] = level + pattern[data.subpage][i] +
+                                (int)(rnd() % (2 * noise + 1)) - noise;
+        }
+        nuc.update(data);
+    }
+    printf("flat field, noise %2u, %d subpages: pattern %5.1f -> %4.1f raw",
+           noise, subpages, residual(nuc_t()), residual(nuc));
+    nuc_t::table8_t table8;
+    nuc.getTable(table8);
+    nuc_t restored;
+    restored.setTable(table8);
+    printf("  (int8 table, shift %u: %4.1f raw)\n", table8.shift,
+           residual(restored));
+}
+
+static void shutterless(uint16_t noise, uint32_t seconds) {
+    bench_unit_t unit(M5_Thermal2::rate_32Hz);
+    unit.sim.setNoise(noise);
+    unit.thermal2.setNoiseFilterLevel(0);
+
+    nuc_t nuc;
+    nuc.setShutterless(true);
+    temperature_data_t data;
+    double update_ns = 0, apply_ns = 0;
+    double err_raw = 0, err_fixed = 0;
+    uint32_t subpages = 0, samples = 0;
+    uint32_t start = micros(), report = 0;
+    printf("shutterless, noise %2u\n", noise);
+    while (micros() - start < seconds * 1000000u) {
+        unit.next(data);
+        const uint16_t* scene = unit.sim.getScene();
+        for (int i = 0; i < pixels; ++i) {
+            data.pixel_raw[i] += pattern[data.subpage][i];
+        }
+        temperature_data_t copy = data;
+        double t0               = nowNs();
+        nuc.apply(copy);
+        double t1 = nowNs();
+        nuc.update(data);
+        update_ns += nowNs() - t1;
+        apply_ns += t1 - t0;
+        ++subpages;
+
+        // Error against the scene, before and after correction.
+        for (int i = 0; i < pixels; ++i) {
+            int y     = i >> 4;
+            int x     = ((i & 15) << 1) + ((y & 1) != data.subpage);
+            int truth = scene[x + y * 32];
+            int raw   = data.pixel_raw[i] - nuc.getOffset(data.subpage, i);
+            err_raw += (double)(raw - truth) * (raw - truth);
+            err_fixed += (double)(data.pixel_raw[i] - truth) *
+                         (data.pixel_raw[i] - truth);
+        }
+        samples += pixels;
+        uint32_t elapsed = (micros() - start) / 1000000u;
+        if (elapsed >= report) {
+            printf(
+                "  %4u s: pattern %5.1f raw  scene error %5.1f raw "
+                "(uncorrected %5.1f)\n",
+                elapsed, residual(nuc), sqrt(err_fixed / samples),
+                sqrt(err_raw / samples));
+            err_raw = err_fixed = 0;
+            samples             = 0;
+            report              = elapsed ? elapsed * 2 : 5;
+        }
+    }
+    printf("  apply %5.0f ns  update (estimator) %6.0f ns per subpage\n",
+           apply_ns / subpages, update_ns / subpages);
+}
+
+int main(int argc, char** argv) {
+    uint16_t noise   = (argc > 1) ? atoi(argv[1]) : 8;
+    uint32_t seconds = (argc > 2) ? atoi(argv[2]) : 320;
+
+    for (auto& p : pattern[0]) p = (int)(rnd() % 129) - 64;
+    for (auto& p : pattern[1]) p = (int)(rnd() % 129) - 64;
+    flatField(0);
+    flatField(24);
+    shutterless(noise, seconds);
+    return 0;
+}
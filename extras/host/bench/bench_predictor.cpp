@@ -0,0 +1,83 @@
+// Host benchmark of the data-ready prediction of M5_Thermal2.
+//
+// The loop of the examples (update(), delay(1) when there is no new
+// subpage) against waitForFrame() before each update(). The simulated
+// unit's clock is off by the given ppm, so the period has to be learned.
+// Reported: bus transactions and loop wakeups per subpage, the time from
+// the subpage becoming ready to update() returning it, and the learned
+// period against the unit's.
+
+#include <Wire.h>
+
+#include "M5_Thermal2.h"
+#include "M5_Thermal2_Simulator.h"
+
+struct result_t {
+    uint32_t frames;
+    uint32_t missed;
+    uint32_t wakeups;
+    uint32_t transactions;
+    uint64_t latency_sum;
+    uint32_t latency_max;
+    uint32_t period;
+    uint32_t sim_period;
+};
+
+static result_t run(bool predict, M5_Thermal2::refresh_rate_t rate,
+                    int32_t skew_ppm, uint32_t seconds) {
+    M5_Thermal2_Simulator sim(&Wire);
+    sim.setClockSkewPpm(skew_ppm);
+    Wire.attach(&sim);
+    M5_Thermal2 thermal2;
+    thermal2.begin(&Wire, M5_Thermal2::i2c_default_addr, 400000, 1000000);
+    thermal2.setRefreshRate(rate);
+    // Let the prediction settle before counting.
+    for (uint32_t start = micros(); micros() - start < 1000000u;) {
+        if (predict) thermal2.waitForFrame();
+        if (!thermal2.update() && !predict) delay(1);
+    }
+
+    result_t r     = {};
+    uint32_t start = micros();
+    uint32_t tr    = Wire.getStats().transactions;
+    uint32_t miss  = sim.getFramesMissed();
+    while (micros() - start < seconds * 1000000u) {
+        ++r.wakeups;
+        if (predict) thermal2.waitForFrame();
+        if (thermal2.update()) {
+            uint32_t latency = hostMicros64() - sim.getLastFrameMicros();
+            ++r.frames;
+            r.latency_sum += latency;
+            if (r.latency_max < latency) r.latency_max = latency;
+        } else if (!predict) {
+            delay(1);
+        }
+    }
+    r.transactions = Wire.getStats().transactions - tr;
+    r.missed       = sim.getFramesMissed() - miss;
+    r.period       = thermal2.getFramePeriodMicros();
+    r.sim_period   = sim.getFramePeriodMicros();
+    Wire.detach(&sim);
+    return r;
+}
+
+static void print(const char* name, const result_t& r) {
+    printf(
+        "%-10s %6u frames %4u missed %6.2f tr/frame %6.2f wakeups/frame  "
+        "latency avg %6.0f max %6u us  period %u (unit %u)\n",
+        name, r.frames, r.missed, (double)r.transactions / r.frames,
+        (double)r.wakeups / r.frames, (double)r.latency_sum / r.frames,
+        r.latency_max, r.period, r.sim_period);
+}
+
+int main(int argc, char** argv) {
+    auto rate = (M5_Thermal2::refresh_rate_t)((argc > 1) ? atoi(argv[1])
+                                                         : 5);  // 16Hz
+    int32_t skew_ppm = (argc > 2) ? atoi(argv[2]) : 20000;
+    uint32_t seconds = (argc > 3) ? atoi(argv[3]) : 20;
+
+    printf("refresh rate %d, unit clock %+d ppm\n", rate, skew_ppm);
+    print("delay(1)", run(false, rate, skew_ppm, seconds));
+    print("predicted", run(true, rate, skew_ppm, seconds));
+    return 0;
+}
@@ -0,0 +1,106 @@
+// Host benchmark of M5_Thermal2_RateGovernor.
+//
+// The simulator's scene alternates between static (60 ~ 61 s, gradient and
+// noise) and active (10 s, orbiting hot spot). The unit runs at 32Hz, with
+// the pixel read clock governor attached, once at a fixed rate and once with
+// the rate governor (latency bound 500 msec). The loop sleeps with
+// waitForFrame() between subpages. Reported: subpages and bus traffic, the
+// time at each rate, and the delay from the hot spot appearing to the
+// governor being back at the active rate.
+
+#include <Wire.h>
+
+#include "M5_Thermal2.h"
+#include "M5_Thermal2_ClockGovernor.h"
+#include "M5_Thermal2_RateGovernor.h"
+#include "M5_Thermal2_Simulator.h"
+#include "bench_util.h"
+
+static constexpr uint32_t quiet_usec  = 60000000u;
+static constexpr uint32_t active_usec = 10000000u;
+
+static uint32_t lcg;
+static uint32_t rnd(void) {
+    lcg = lcg * 1664525u + 1013904223u;
+    return lcg >> 8;
+}
+
+static void run(bool govern, uint16_t noise, uint32_t seconds) {
+    bench_unit_t unit(M5_Thermal2::rate_32Hz);
+    unit.sim.setNoise(noise);
+    unit.sim.setHotSpot(false);
+    unit.thermal2.setNoiseFilterLevel(0);
+    M5_Thermal2_ClockGovernor clock;
+    clock.begin(&unit.thermal2);
+    M5_Thermal2_RateGovernor governor;
+    if (govern) governor.begin(&unit.thermal2, &clock);
+
+    M5_Thermal2::temperature_data_t data;
+    uint32_t frames = 0, onsets = 0;
+    uint64_t latency_sum = 0;
+    uint32_t latency_max = 0;
+    bool active          = false;
+    bool pending         = false;
+    uint32_t missed      = unit.sim.getFramesMissed();
+    unit.sim.resetTraffic();
+    uint32_t start = micros();
+    // Up to 1 s of jitter on the quiet phases, so the onsets fall anywhere
+    // within a subpage period. Both runs see the same sequence.
+    lcg             = 12345;
+    uint32_t change = start + quiet_usec + rnd() % 1000000u;
+    while (micros() - start < seconds * 1000000u) {
+        // The loop wakes around subpages only, so the latency is counted
+        // from the scheduled change, not from when the loop noticed it.
+        if ((int32_t)(micros() - change) >= 0) {
+            active = !active;
+            unit.sim.setHotSpot(active);
+            if (active) {
+                pending = true;
+                ++onsets;
+                change += active_usec;
+            } else {
+                change += quiet_usec + rnd() % 1000000u;
+            }
+        }
+        unit.thermal2.waitForFrame();
+        bool updated = unit.thermal2.update(data);
+        clock.update(updated);
+        if (!updated) continue;
+        ++frames;
+        if (govern) governor.update(data);
+        if (pending && (!govern || governor.getRate() ==
+                                       governor.getActiveRate())) {
+            uint32_t latency = micros() - (change - active_usec);
+            latency_sum += latency;
+            if (latency_max < latency) latency_max = latency;
+            pending = false;
+        }
+    }
+    auto& traffic = unit.sim.getTotalTraffic();
+    printf(
+        "%-8s %6u subpages (%u missed)  %7.1f kB read  bus %6.1f s  "
+        "activity seen after avg %4.0f max %4.0f ms\n",
+        govern ? "governed" : "fixed", frames,
+        unit.sim.getFramesMissed() - missed, traffic.bytes_read / 1000.0,
+        traffic.bus_time_ns / 1e9,
+        onsets ? latency_sum / 1000.0 / onsets : 0.0, latency_max / 1000.0);
+    if (govern) {
+        for (int rate = M5_Thermal2::rate_64Hz; rate >= 0; --rate) {
+            auto r        = (M5_Thermal2::refresh_rate_t)rate;
+            uint64_t usec = governor.getMicrosAtRate(r);
+            if (usec == 0) continue;
+            printf("    rate %d (%4.1f Hz)  %6.1f s  %5.1f %%  %6u subpages\n",
+                   rate, 1000000.0 / (2000000u >> rate), usec / 1e6,
+                   100.0 * usec / (seconds * 1e6), governor.getFramesAtRate(r));
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    uint16_t noise   = (argc > 1) ? atoi(argv[1]) : 24;
+    uint32_t seconds = (argc > 2) ? atoi(argv[2]) : 280;
+
+    run(false, noise, seconds);
+    run(true, noise, seconds);
+    return 0;
+}
@@ -0,0 +1,52 @@
+// Host benchmark of the pixel read restart.
+//
+// Runs update() at 64Hz with an 800kHz pixel clock while the simulated unit
+// cuts pixel reads short at a given rate, and reports how many frames each
+// restart budget delivers.
+
+#include <Wire.h>
+
+#include "M5_Thermal2.h"
+#include "M5_Thermal2_Simulator.h"
+#include "bench_util.h"
+
+int main(int argc, char** argv) {
+    uint32_t ppm     = (argc > 1) ? atoi(argv[1]) : 20000;
+    uint32_t freq    = (argc > 2) ? atoi(argv[2]) : 800000;
+    uint32_t seconds = (argc > 3) ? atoi(argv[3]) : 20;
+
+    printf("pixel read error rate %.2f %%  pixel clock %u Hz  64Hz, %u s\n",
+           ppm / 10000.0, freq, seconds);
+    static const uint8_t budgets[] = {0, 1, 2, 4};
+    for (auto budget : budgets) {
+        bench_unit_t unit(M5_Thermal2::rate_64Hz, 400000, freq);
+        unit.thermal2.setPixelRestart(budget);
+        unit.sim.setPixelReadErrorRate(ppm);
+
+        uint32_t ok = 0, failed_frames = 0;
+        uint32_t generated0 = unit.sim.getFramesGenerated();
+        uint32_t missed0    = unit.sim.getFramesMissed();
+        uint64_t end_us     = hostMicros64() + seconds * 1000000ull;
+        while (hostMicros64() < end_us) {
+            uint32_t dropped = unit.thermal2.getChunkDroppedCount();
+            if (unit.thermal2.update()) {
+                ++ok;
+            } else {
+                if (dropped != unit.thermal2.getChunkDroppedCount()) {
+                    ++failed_frames;
+                }
+                delay(1);
+            }
+        }
+        uint32_t generated = unit.sim.getFramesGenerated() - generated0;
+        printf(
+            "restarts %u  frames %5u / %5u (%5.1f %%) missed %4u  failed %4u  "
+            "restarted %4u  chunks recovered %4u dropped %4u\n",
+            budget, ok, generated, 100.0 * ok / generated,
+            unit.sim.getFramesMissed() - missed0, failed_frames,
+            unit.thermal2.getPixelRestartCount(),
+            unit.thermal2.getChunkRecoveredCount(),
+            unit.thermal2.getChunkDroppedCount());
+    }
+    return 0;
+}
@@ -0,0 +1,156 @@
+// Host benchmark of M5_Thermal2_RoiEngine.
+//
+// A rule set of rectangles (bearings, motors, cabinet zones) is evaluated on
+// every frame. The reference loops over the pixels of each rectangle, the
+// engine builds its tables once per frame and looks the sums, lowest and
+// highest up. Sets: random rectangles of any size, small zones and large
+// areas (half the frame or more). The last column is the engine with
+// averages only. Results are checked against the reference.
+
+#include <Wire.h>
+
+#include "M5_Thermal2.h"
+#include "M5_Thermal2_RoiEngine.h"
+#include "M5_Thermal2_Simulator.h"
+#include "bench_util.h"
+
+using roi_t       = M5_Thermal2_RoiEngine::roi_t;
+using roi_stats_t = M5_Thermal2_RoiEngine::roi_stats_t;
+
+static constexpr int frame_width  = M5_Thermal2::frame_width;
+static constexpr int frame_height = M5_Thermal2::frame_height;
+static constexpr int frames       = 32;
+static constexpr int roi_max      = 256;
+
+static uint16_t scene[frames][frame_width * frame_height];
+static roi_t rois[roi_max];
+static roi_t zones[roi_max];
+static roi_t areas[roi_max];
+static roi_stats_t ref_stats[roi_max];
+static roi_stats_t lib_stats[roi_max];
+static M5_Thermal2_RoiEngine engine;
+
+static void referenceQuery(const uint16_t* frame, const roi_t& roi,
+                           roi_stats_t& dst) {
+    uint32_t sum     = 0;
+    uint16_t lowest  = 65535;
+    uint16_t highest = 0;
+    for (int y = roi.y; y < roi.y + roi.h; ++y) {
+        const uint16_t* src = &frame[y * frame_width];
+        for (int x = roi.x; x < roi.x + roi.w; ++x) {
+            uint16_t v = src[x];
+            sum += v;
+            if (lowest > v) lowest = v;
+            if (highest < v) highest = v;
+        }
+    }
+    dst.sum     = sum;
+    dst.count   = roi.w * roi.h;
+    dst.lowest  = lowest;
+    dst.highest = highest;
+    dst.average = sum / dst.count;
+}
+
+int main(int argc, char** argv) {
+    int iterations = (argc > 1) ? atoi(argv[1]) : 200;
+
+    bench_unit_t unit(M5_Thermal2::rate_8Hz, 400000, 400000);
+    for (int f = 0; f < frames; ++f) {
+        unit.next();
+        memcpy(scene[f], unit.sim.getScene(), sizeof(scene[0]));
+    }
+
+    // Random rectangles, from single pixels up to the whole frame, and a
+    // rule set of small zones (2x2 ~ 8x6, as bearings or motors) and of
+    // large areas. (16x12 ~ 32x24, as cabinets or conveyor sections)
+    uint32_t lcg = 12345;
+    for (int i = 0; i < roi_max; ++i) {
+        lcg   = lcg * 1103515245u + 12345u;
+        int w = 1 + (lcg >> 8) % frame_width;
+        int h = 1 + (lcg >> 16) % frame_height;
+        lcg   = lcg * 1103515245u + 12345u;
+        rois[i]  = {(uint8_t)((lcg >> 8) % (frame_width - w + 1)),
+                    (uint8_t)((lcg >> 16) % (frame_height - h + 1)),
+                    (uint8_t)w, (uint8_t)h};
+        lcg   = lcg * 1103515245u + 12345u;
+        w     = 2 + (lcg >> 8) % 7;
+        h     = 2 + (lcg >> 16) % 5;
+        lcg   = lcg * 1103515245u + 12345u;
+        zones[i] = {(uint8_t)((lcg >> 8) % (frame_width - w + 1)),
+                    (uint8_t)((lcg >> 16) % (frame_height - h + 1)),
+                    (uint8_t)w, (uint8_t)h};
+        lcg   = lcg * 1103515245u + 12345u;
+        w     = 16 + (lcg >> 8) % 17;
+        h     = 12 + (lcg >> 16) % 13;
+        lcg   = lcg * 1103515245u + 12345u;
+        areas[i] = {(uint8_t)((lcg >> 8) % (frame_width - w + 1)),
+                    (uint8_t)((lcg >> 16) % (frame_height - h + 1)),
+                    (uint8_t)w, (uint8_t)h};
+    }
+    static const roi_t* const sets[]    = {rois, zones, areas};
+    static const char* const set_name[] = {"random", "zones", "areas"};
+    int mismatch                        = 0;
+    for (auto set : sets) {
+        for (int f = 0; f < frames; ++f) {
+            engine.update(scene[f]);
+            engine.query(set, roi_max, lib_stats);
+            for (int i = 0; i < roi_max; ++i) {
+                referenceQuery(scene[f], set[i], ref_stats[i]);
+                mismatch += memcmp(&ref_stats[i], &lib_stats[i],
+                                   sizeof(roi_stats_t)) != 0;
+            }
+        }
+    }
+
+    volatile uint32_t sink = 0;
+    double n               = (double)iterations * frames;
+    double t0              = nowNs();
+    for (int it = 0; it < iterations; ++it) {
+        for (int f = 0; f < frames; ++f) {
+            engine.update(scene[f]);
+            sink += engine.query(rois, 0, lib_stats);
+        }
+    }
+    double update_ns = (nowNs() - t0) / n;
+
+    printf("update %.0f ns, %u bytes\n", update_ns, (unsigned)sizeof(engine));
+    printf("%-7s %5s %14s %14s %8s %14s\n", "set", "rois", "reference ns",
+           "engine ns", "ratio", "averages ns");
+    static const int counts[] = {1, 4, 16, 64, 256};
+    for (int s = 0; s < 3; ++s) {
+        const roi_t* set = sets[s];
+        for (int count : counts) {
+            double t1 = nowNs();
+            for (int it = 0; it < iterations; ++it) {
+                for (int f = 0; f < frames; ++f) {
+                    for (int i = 0; i < count; ++i) {
+                        referenceQuery(scene[f], set[i], ref_stats[i]);
+                    }
+                    sink += ref_stats[0].highest;
+                }
+            }
+            double t2 = nowNs();
+            for (int it = 0; it < iterations; ++it) {
+                for (int f = 0; f < frames; ++f) {
+                    engine.update(scene[f]);
+                    engine.query(set, count, lib_stats);
+                    sink += lib_stats[0].highest;
+                }
+            }
+            double t3 = nowNs();
+            for (int it = 0; it < iterations; ++it) {
+                for (int f = 0; f < frames; ++f) {
+                    engine.update(scene[f], false);
+                    engine.query(set, count, lib_stats);
+                    sink += lib_stats[0].average;
+                }
+            }
+            double t4 = nowNs();
+            printf("%-7s %5d %14.0f %14.0f %7.2fx %14.0f\n",
+                   set_name[s], count, (t2 - t1) / n,
+                   (t3 - t2) / n, (t2 - t1) / (t3 - t2), (t4 - t3) / n);
+        }
+    }
+    printf("mismatches against the pixel loop: %d\n", mismatch);
+    return (mismatch != 0) || sink == 0xFFFFFFFFu;
+}
@@ -0,0 +1,64 @@
+// Host benchmark of partial pixel reads (M5_Thermal2::setPixelRows).
+//
+// The unit runs at the given refresh rate on a bus whose pixel clock is too
+// slow to read the whole 768 byte stream every subpage. The loop of the
+// examples (update(), delay(1) when there is no new subpage) runs with
+// fewer and fewer rows read. Reported per setting: subpages per second,
+// subpages lost, bus bytes and bus time per subpage, and the pixel bytes
+// the setting saved.
+
+#include <Wire.h>
+
+#include "M5_Thermal2.h"
+#include "M5_Thermal2_Simulator.h"
+
+static void run(uint8_t rows, M5_Thermal2::refresh_rate_t rate,
+                uint32_t freq, uint32_t seconds) {
+    M5_Thermal2_Simulator sim(&Wire);
+    Wire.attach(&sim);
+    M5_Thermal2 thermal2;
+    thermal2.begin(&Wire, M5_Thermal2::i2c_default_addr, freq, freq);
+    thermal2.setRefreshRate(rate);
+    thermal2.setAcquisitionProfile(M5_Thermal2::profile_pixels_only);
+    thermal2.setPixelRows(rows);
+    delay(100);
+    thermal2.update();
+
+    Wire.resetStats();
+    uint32_t frames = 0;
+    uint32_t stale  = 0;
+    uint32_t missed = sim.getFramesMissed();
+    uint32_t saved  = thermal2.getSavedPixelBytes();
+    uint32_t start  = micros();
+    while (micros() - start < seconds * 1000000u) {
+        if (thermal2.update()) {
+            ++frames;
+            stale = thermal2.getTemperatureData().stale_rows;
+        } else {
+            delay(1);
+        }
+    }
+    uint32_t usec = micros() - start;
+    auto& bus     = Wire.getStats();
+    printf(
+        "rows %2u  %6.1f fps  %5u missed  %7.1f bytes/frame  %7.0f us "
+        "bus/frame  saved %5.1f bytes/frame  stale 0x%06x\n",
+        rows, frames * 1e6 / usec, sim.getFramesMissed() - missed,
+        (double)(bus.bytes_read + bus.bytes_written) / frames,
+        bus.bus_time_ns / 1e3 / frames,
+        (double)(thermal2.getSavedPixelBytes() - saved) / frames, stale);
+    Wire.detach(&sim);
+}
+
+int main(int argc, char** argv) {
+    auto rate = (M5_Thermal2::refresh_rate_t)((argc > 1) ? atoi(argv[1])
+                                                         : 7);  // 64Hz
+    uint32_t freq    = (argc > 2) ? atoi(argv[2]) : 400000;
+    uint32_t seconds = (argc > 3) ? atoi(argv[3]) : 10;
+
+    printf("%u subpages/s, pixel clock %u\n", 1u << (rate - 1), freq);
+    for (uint8_t rows : {24, 20, 16, 12, 8, 4}) {
+        run(rows, rate, freq, seconds);
+    }
+    return 0;
+}
@@ -0,0 +1,134 @@
+// Host benchmark of M5_Thermal2_Scheduler.
+//
+// Several simulated units share one bus (or are split over two). The
+// reference is the loop of the examples run for every unit: update() each
+// unit and delay(1) when none had a new subpage. The scheduler starts a unit
+// only when its subpage is due and interleaves the units' transactions.
+// Reported per setup: subpages per second, subpages the units produced
+// but nobody read, bus transactions per subpage and bus utilisation.
+// The host has one virtual clock and blocking transfers, as a single task
+// on the MCU does, so two buses give the same throughput as one here.
+
+#include <Wire.h>
+
+#include "M5_Thermal2.h"
+#include "M5_Thermal2_Scheduler.h"
+#include "M5_Thermal2_Simulator.h"
+
+static constexpr int unit_count = 4;
+
+struct result_t {
+    double fps;
+    uint32_t missed;
+    double transactions_per_frame;
+    double utilization;
+};
+
+struct rig_t {
+    TwoWire wire1;
+    M5_Thermal2_Simulator* sim[unit_count];
+    M5_Thermal2 unit[unit_count];
+    uint32_t missed_start = 0;
+
+    rig_t(int buses, M5_Thermal2::refresh_rate_t rate, uint32_t freq) {
+        Wire.resetStats();
+        for (int i = 0; i < unit_count; ++i) {
+            TwoWire* wire = (buses > 1 && (i & 1)) ? &wire1 : &Wire;
+            uint8_t addr  = M5_Thermal2::i2c_default_addr + i;
+            sim[i]        = new M5_Thermal2_Simulator(wire, addr);
+            wire->attach(sim[i]);
+            unit[i].begin(wire, addr, 400000, freq);
+            unit[i].setRefreshRate(rate);
+            unit[i].setAcquisitionProfile(M5_Thermal2::profile_pixels_only);
+        }
+        // Settle the configuration and drain the first subpages, then
+        // start counting.
+        delay(100);
+        for (auto& u : unit) u.update();
+        Wire.resetStats();
+        wire1.resetStats();
+        for (auto s : sim) {
+            s->resetTraffic();
+            missed_start += s->getFramesMissed();
+        }
+    }
+    ~rig_t() {
+        for (int i = 0; i < unit_count; ++i) {
+            unit[i].getWire()->detach(sim[i]);
+            delete sim[i];
+        }
+    }
+    result_t result(uint32_t frames, uint32_t usec) {
+        result_t r;
+        uint32_t missed = -missed_start;
+        for (auto s : sim) missed += s->getFramesMissed();
+        uint32_t tr =
+            Wire.getStats().transactions + wire1.getStats().transactions;
+        uint64_t ns =
+            Wire.getStats().bus_time_ns + wire1.getStats().bus_time_ns;
+        r.fps                    = frames * 1e6 / usec;
+        r.missed                 = missed;
+        r.transactions_per_frame = frames ? (double)tr / frames : 0;
+        r.utilization            = ns / 1e3 / usec;
+        return r;
+    }
+};
+
+static result_t runReference(int buses, M5_Thermal2::refresh_rate_t rate,
+                             uint32_t freq, uint32_t seconds) {
+    rig_t rig(buses, rate, freq);
+    uint32_t frames = 0;
+    uint32_t start  = micros();
+    while (micros() - start < seconds * 1000000u) {
+        bool any = false;
+        for (auto& unit : rig.unit) {
+            if (unit.update()) {
+                ++frames;
+                any = true;
+            }
+        }
+        if (!any) delay(1);
+    }
+    return rig.result(frames, micros() - start);
+}
+
+static void countFrame(void* user, uint8_t, uint32_t,
+                       const M5_Thermal2::temperature_data_t&) {
+    ++*(uint32_t*)user;
+}
+
+static result_t runScheduler(int buses, M5_Thermal2::refresh_rate_t rate,
+                             uint32_t freq, uint32_t seconds) {
+    rig_t rig(buses, rate, freq);
+    M5_Thermal2_Scheduler scheduler;
+    uint32_t frames = 0;
+    for (auto& unit : rig.unit) scheduler.addUnit(&unit);
+    scheduler.setCallback(countFrame, &frames);
+    uint32_t start = micros();
+    while (micros() - start < seconds * 1000000u) {
+        scheduler.update();
+        uint32_t idle = scheduler.getIdleMicros();
+        if (idle) delayMicroseconds(idle);
+    }
+    return rig.result(frames, micros() - start);
+}
+
+static void print(const char* name, const result_t& r) {
+    printf("%-22s %7.1f fps %7u missed %7.2f tr/frame %6.1f%% bus\n", name,
+           r.fps, r.missed, r.transactions_per_frame, r.utilization * 100);
+}
+
+int main(int argc, char** argv) {
+    auto rate = (M5_Thermal2::refresh_rate_t)((argc > 1) ? atoi(argv[1])
+                                                         : 5);  // 16Hz
+    uint32_t freq    = (argc > 2) ? atoi(argv[2]) : 1000000;
+    uint32_t seconds = (argc > 3) ? atoi(argv[3]) : 10;
+
+    printf("%d units, %u subpages/s each (%u in total), pixel clock %u\n",
+           unit_count, 1u << (rate - 1), unit_count << (rate - 1), freq);
+    print("1 bus  reference", runReference(1, rate, freq, seconds));
+    print("1 bus  scheduler", runScheduler(1, rate, freq, seconds));
+    print("2 buses reference", runReference(2, rate, freq, seconds));
+    print("2 buses scheduler", runScheduler(2, rate, freq, seconds));
+    return 0;
+}
@@ -0,0 +1,69 @@
+// Host report of the M5_THERMAL2_ENABLE_STATS instrumentation.
+//
+// Runs update() against the simulated unit with pixel read errors and a
+// loop that sometimes falls behind, then prints the per-phase timings, the
+// sequence counters and the failure categories. Build with `make STATS=1`.
+
+#include <Wire.h>
+
+#include "M5_Thermal2.h"
+#include "M5_Thermal2_Simulator.h"
+#include "bench_util.h"
+
+#if defined(M5_THERMAL2_ENABLE_STATS)
+static void print(const char* name, const M5_Thermal2::phase_timing_t& t) {
+    printf("%-16s avg %6u us  max %6u us  count %6u\n", name,
+           t.getAverageMicros(), t.max_usec, t.count);
+}
+
+static const char* const failure_name[] = {
+    "init", "not ready", "nack", "short read", "sanity", "subpage changed",
+    "busy"};
+#endif
+
+int main(int argc, char** argv) {
+#if !defined(M5_THERMAL2_ENABLE_STATS)
+    (void)argc;
+    (void)argv;
+    printf("stats disabled. (build with make STATS=1)\n");
+    return 0;
+#else
+    int rate      = (argc > 1) ? atoi(argv[1]) : M5_Thermal2::rate_32Hz;
+    uint32_t freq = (argc > 2) ? atoi(argv[2]) : 800000;
+    uint32_t ppm  = (argc > 3) ? atoi(argv[3]) : 10000;
+
+    bench_unit_t unit((M5_Thermal2::refresh_rate_t)rate, 400000, freq);
+    unit.thermal2.resetStats();
+    unit.sim.setPixelReadErrorRate(ppm);
+
+    uint32_t generated0 = unit.sim.getFramesGenerated();
+    uint32_t missed0    = unit.sim.getFramesMissed();
+    uint64_t end_us     = hostMicros64() + 20000000u;
+    uint32_t loops      = 0;
+    while (hostMicros64() < end_us) {
+        if (!unit.thermal2.update()) delay(1);
+        // Every 50th loop stalls for 3 refresh periods.
+        if (++loops % 50 == 0) delay(3 * (2000 >> rate));
+    }
+
+    auto& st = unit.thermal2.getStats();
+    print("status", st.status);
+    print("refresh control", st.refresh_control);
+    print("overview", st.overview);
+    for (int i = 0; i < 6; ++i) {
+        char name[16];
+        snprintf(name, sizeof(name), "pixel chunk %d", i);
+        print(name, st.pixel_chunk[i]);
+    }
+    print("pixel restart", st.pixel_restart);
+    print("ack", st.ack);
+    printf("frames %u (subpage 0:%u 1:%u)  missed %u (simulator: %u of %u)\n",
+           st.frame_seq, st.subpage_seq[0], st.subpage_seq[1],
+           st.missed_subpages, unit.sim.getFramesMissed() - missed0,
+           unit.sim.getFramesGenerated() - generated0);
+    for (int i = 0; i < M5_Thermal2::failure_max; ++i) {
+        printf("failure %-16s %u\n", failure_name[i], st.failures[i]);
+    }
+    return 0;
+#endif
+}
@@ -0,0 +1,102 @@
+// Host benchmark of the tile change map of M5_Thermal2_FrameAssembler and
+// the changed-tile rendering of M5_Thermal2_Renderer.
+//
+// Subpages from the simulator (moving hot spot on a static background, with
+// the given noise) are assembled; after each merge the changed tiles are
+// rendered into a persistent 320x240 image and the map is cleared, as a
+// display loop would. Reported: changed tiles and output pixels per frame,
+// and render time against rendering every pixel. With change threshold 0
+// the persistent image must equal a full render of the last frame.
+
+#include <Wire.h>
+
+#include "M5_Thermal2.h"
+#include "M5_Thermal2_FrameAssembler.h"
+#include "M5_Thermal2_Renderer.h"
+#include "M5_Thermal2_Simulator.h"
+#include "bench_util.h"
+
+typedef M5_Thermal2::temperature_data_t temperature_data_t;
+
+static constexpr int width    = 320;
+static constexpr int height   = 240;
+static constexpr int subpages = 512;
+
+static temperature_data_t source[subpages];
+static uint16_t image[width * height];
+static uint16_t full[width * height];
+
+static void record(uint16_t noise) {
+    bench_unit_t unit(M5_Thermal2::rate_32Hz);
+    unit.sim.setNoise(noise);
+    unit.thermal2.setNoiseFilterLevel(0);
+    for (int n = 0; n < subpages; ++n) {
+        unit.next();
+        source[n] = unit.thermal2.getTemperatureData();
+    }
+}
+
+static uint32_t span_pixels;
+
+static void storeSpan(void* user, uint16_t y, uint16_t x, const uint16_t* row,
+                      uint16_t w) {
+    memcpy(&((uint16_t*)user)[x + y * width], row, w * sizeof(uint16_t));
+    span_pixels += w;
+}
+
+static void storeRow(void* user, uint16_t y, const uint16_t* row,
+                     uint16_t w) {
+    memcpy(&((uint16_t*)user)[y * w], row, w * sizeof(uint16_t));
+}
+
+static void run(uint16_t noise, uint16_t threshold) {
+    static uint16_t index_map[256];
+    for (int i = 0; i < 256; ++i) index_map[i] = i;
+    M5_Thermal2_Renderer renderer;
+    renderer.setSize(width, height);
+    renderer.setColorMap(index_map);
+    // Fixed range, as a display with a locked range would use.
+    renderer.setRange(M5_Thermal2::convertCelsiusToRaw(20),
+                      M5_Thermal2::convertCelsiusToRaw(62));
+
+    M5_Thermal2_FrameAssembler assembler;
+    assembler.setChangeThreshold(threshold);
+    uint64_t tiles    = 0;
+    double changed_ns = 0;
+    double full_ns    = 0;
+    span_pixels       = 0;
+    for (int n = 0; n < subpages; ++n) {
+        assembler.merge(source[n]);
+        uint64_t map = assembler.getChangeMap();
+        tiles += __builtin_popcountll(map);
+        double t0 = nowNs();
+        renderer.render(assembler.getFrame().pixel_raw, map, storeSpan,
+                        image);
+        double t1 = nowNs();
+        renderer.render(assembler.getFrame().pixel_raw, storeRow, full);
+        full_ns += nowNs() - t1;
+        changed_ns += t1 - t0;
+        assembler.clearChangeMap();
+    }
+    int mismatch = 0;
+    for (int i = 0; i < width * height; ++i) mismatch += image[i] != full[i];
+    printf(
+        "noise %2u threshold %3u  %5.1f / 48 tiles  %6.0f / %u pixels  "
+        "render %6.1f us (all pixels %6.1f us)  differing pixels %d\n",
+        noise, threshold, (double)tiles / subpages,
+        (double)span_pixels / subpages, width * height,
+        changed_ns / 1e3 / subpages, full_ns / 1e3 / subpages, mismatch);
+}
+
+int main(int argc, char** argv) {
+    uint16_t noise = (argc > 1) ? atoi(argv[1]) : 8;
+
+    record(0);
+    run(0, 0);
+    run(0, 32);
+    record(noise);
+    run(noise, 0);
+    run(noise, 32);
+    run(noise, 64);
+    return 0;
+}
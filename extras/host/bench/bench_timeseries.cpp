@@ -0,0 +1,121 @@
+// Host benchmark of M5_Thermal2_TimeSeries.
+//
+// Overview samples (random walk with occasional spikes, as a hot object
+// passing) are pushed into a store of 4096 samples with windows of 64, 256,
+// 1024 and 4096 samples. Every few pushes the statistics of each window and
+// channel are checked against a rescan of the kept samples; one window is
+// resized half way. Reported: mismatches, push and query cost, and the cost
+// of the rescan they replace.
+
+#include <Wire.h>
+#include <math.h>
+
+#include "M5_Thermal2.h"
+#include "M5_Thermal2_TimeSeries.h"
+#include "bench_util.h"
+
+typedef M5_Thermal2_TimeSeries<4096, 4> series_t;
+
+static series_t series;
+
+static uint32_t lcg = 12345;
+static uint32_t rnd(void) {
+    lcg = lcg * 1664525u + 1013904223u;
+    return lcg >> 8;
+}
+
+static M5_Thermal2::temperature_reg_t sample(void) {
+    static int level = 90 * 128;
+    level += (int)(rnd() % 65) - 32;
+    if (level < 70 * 128) level = 70 * 128;
+    if (level > 110 * 128) level = 110 * 128;
+    M5_Thermal2::temperature_reg_t reg = {};
+    reg.lowest_raw  = level - 512 + rnd() % 64;
+    reg.median_raw  = level + rnd() % 64;
+    reg.average_raw = level + 64 + rnd() % 64;
+    reg.highest_raw = level + 1024 + rnd() % 256;
+    if (rnd() % 500 == 0) reg.highest_raw += 2048;
+    return reg;
+}
+
+static series_t::stats_t rescan(uint8_t window, series_t::channel_t c) {
+    series_t::stats_t s = {};
+    uint32_t n          = series.getWindow(window);
+    if (n > series.size()) n = series.size();
+    s.count      = n;
+    s.lowest_raw = UINT16_MAX;
+
+    double sum = 0, sum_x = 0, sum_xx = 0, sum_xy = 0;
+    for (uint32_t x = 0; x < n; ++x) {
+        uint16_t v = series.getRaw(c, n - 1 - x);
+        if (s.lowest_raw > v) s.lowest_raw = v;
+        if (s.highest_raw < v) s.highest_raw = v;
+        sum += v;
+        sum_x += x;
+        sum_xx += (double)x * x;
+        sum_xy += (double)x * v;
+    }
+    s.mean_raw = sum / n;
+    if (n > 1) {
+        s.slope_raw = (n * sum_xy - sum_x * sum) / (n * sum_xx - sum_x * sum_x);
+    }
+    return s;
+}
+
+static bool same(const series_t::stats_t& a, const series_t::stats_t& b) {
+    return a.count == b.count && a.lowest_raw == b.lowest_raw &&
+           a.highest_raw == b.highest_raw &&
+           fabsf(a.mean_raw - b.mean_raw) < 0.01f &&
+           fabsf(a.slope_raw - b.slope_raw) <
+               1e-4f + fabsf(b.slope_raw) * 1e-4f;
+}
+
+int main(int argc, char** argv) {
+    uint32_t pushes         = (argc > 1) ? atoi(argv[1]) : 50000;
+    const uint32_t length[] = {64, 256, 1024, 4096};
+    for (uint8_t w = 0; w < 4; ++w) series.setWindow(w, length[w]);
+
+    int checks     = 0;
+    int errors     = 0;
+    double push_ns = 0;
+    for (uint32_t i = 0; i < pushes; ++i) {
+        if (i == pushes / 2) series.setWindow(1, 500);
+        auto reg  = sample();
+        double t0 = nowNs();
+        series.push(reg, i * 15625u);  // 64 Hz
+        push_ns += nowNs() - t0;
+        if (i % 37) continue;
+        for (uint8_t w = 0; w < 4; ++w) {
+            for (uint8_t c = 0; c < series_t::channel_max; ++c) {
+                auto ch = (series_t::channel_t)c;
+                ++checks;
+                errors += !same(series.getStats(w, ch), rescan(w, ch));
+            }
+        }
+    }
+    printf("pushes %u, checks %d, mismatches %d\n", pushes, checks, errors);
+    printf("push (4 windows x 4 channels)  %6.1f ns\n", push_ns / pushes);
+
+    const int queries   = 100000;
+    volatile float sink = 0;
+    for (uint8_t w = 0; w < 4; ++w) {
+        double t0 = nowNs();
+        for (int i = 0; i < queries; ++i) {
+            auto ch = (series_t::channel_t)(i & 3);
+            sink    = sink + series.getStats(w, ch).mean_raw;
+        }
+        double t1 = nowNs();
+        for (int i = 0; i < queries / 100; ++i) {
+            sink = sink + rescan(w, series_t::channel_highest).mean_raw;
+        }
+        double t2 = nowNs();
+        auto s    = series.getStats(w, series_t::channel_highest);
+        printf(
+            "window %4u  query %6.1f ns  rescan %9.1f ns  "
+            "highest %5.2f..%5.2f C  slope %+6.3f C/s\n",
+            series.getWindow(w), (t1 - t0) / queries,
+            (t2 - t1) / (queries / 100), s.getLowestTemperature(),
+            s.getHighestTemperature(), s.getSlopePerSecond());
+    }
+    return 0;
+}
@@ -0,0 +1,157 @@
+// Host benchmark of M5_Thermal2 I2C traffic and CPU cost.
+//
+// Measures begin() (_checkInit), a typical startup configuration
+// (_updateConfig) and update() with each acquisition profile against the
+// simulated unit, reporting the transactions, bytes and simulated bus time
+// each one costs.
+
+#include <Wire.h>
+
+#include "M5_Thermal2.h"
+#include "M5_Thermal2_Simulator.h"
+#include "bench_util.h"
+
+typedef M5_Thermal2_Simulator::traffic_t traffic_t;
+
+static traffic_t diff(const traffic_t& a, const traffic_t& b) {
+    traffic_t r;
+    r.transactions       = a.transactions - b.transactions;
+    r.write_transactions = a.write_transactions - b.write_transactions;
+    r.read_transactions  = a.read_transactions - b.read_transactions;
+    r.bytes_written      = a.bytes_written - b.bytes_written;
+    r.bytes_read         = a.bytes_read - b.bytes_read;
+    r.bus_time_ns        = a.bus_time_ns - b.bus_time_ns;
+    return r;
+}
+
+static void add(traffic_t& sum, const traffic_t& t) {
+    sum.transactions += t.transactions;
+    sum.write_transactions += t.write_transactions;
+    sum.read_transactions += t.read_transactions;
+    sum.bytes_written += t.bytes_written;
+    sum.bytes_read += t.bytes_read;
+    sum.bus_time_ns += t.bus_time_ns;
+}
+
+static void print(const char* name, const traffic_t& t, uint32_t div = 1) {
+    printf(
+        "%-28s tr:%7.2f (w:%6.2f r:%6.2f)  bytes w:%8.2f r:%8.2f  "
+        "bus:%9.1f us\n",
+        name, (double)t.transactions / div, (double)t.write_transactions / div,
+        (double)t.read_transactions / div, (double)t.bytes_written / div,
+        (double)t.bytes_read / div, (double)t.bus_time_ns / 1000.0 / div);
+}
+
+int main(int argc, char** argv) {
+    int rate      = (argc > 1) ? atoi(argv[1]) : M5_Thermal2::rate_32Hz;
+    uint32_t freq = (argc > 2) ? atoi(argv[2]) : 400000;
+    uint32_t want = (argc > 3) ? atoi(argv[3]) : 1000;
+
+    M5_Thermal2_Simulator sim(&Wire);
+    Wire.attach(&sim);
+    Wire.begin();
+
+    M5_Thermal2 thermal2;
+    traffic_t t0 = sim.getTotalTraffic();
+    if (!thermal2.begin(&Wire, M5_Thermal2::i2c_default_addr, freq, freq)) {
+        printf("begin failed\n");
+        return 1;
+    }
+    print("begin (_checkInit)", diff(sim.getTotalTraffic(), t0));
+
+    // Same sequence as examples/HowToUse, one write per setter and batched.
+    for (int batched = 0; batched < 2; ++batched) {
+        M5_Thermal2_Simulator sim_cfg(&Wire, 0x40);
+        Wire.attach(&sim_cfg);
+        M5_Thermal2 unit;
+        unit.begin(&Wire, 0x40, freq, freq);
+        sim_cfg.resetTraffic();
+        if (batched) unit.beginConfig();
+        unit.setRefreshRate(rate);
+        unit.setNoiseFilterLevel(8);
+        unit.ledOff();
+        unit.buzzerOff();
+        unit.setBuzzer(2000, 64);
+        unit.setLed(0, 4, 0);
+        unit.setAlarmHighTemp(50.0, 25, 6000, 4, 0, 0);
+        unit.setAlarmLowTemp(20.0, 25, 2000, 0, 0, 4);
+        unit.setMonitorArea(15, 11);
+        unit.alarmOn();
+        if (batched) unit.commit();
+        print(batched ? "startup config (batched)" : "startup config (setters)",
+              sim_cfg.getTotalTraffic());
+        printf("%-28s %u bytes into 0x08~0x37\n", "",
+               sim_cfg.getConfigBytesWritten());
+        Wire.detach(&sim_cfg);
+    }
+    thermal2.setRefreshRate(rate);
+
+    static const char* const profile_name[] = {"full", "pixels only"};
+    for (int p = 0; p < 2; ++p) {
+        auto profile = (M5_Thermal2::acquisition_profile_t)p;
+        thermal2.setAcquisitionProfile(profile);
+        uint32_t ok = 0, calls = 0;
+        double cpu_ns = 0;
+        traffic_t frame_sum = {}, poll_sum = {};
+        t0                  = sim.getTotalTraffic();
+        uint64_t start_us   = hostMicros64();
+        uint32_t missed0    = sim.getFramesMissed();
+        uint32_t saved0     = thermal2.getSavedTransactions();
+        while (ok < want) {
+            traffic_t before = sim.getTotalTraffic();
+            double s         = nowNs();
+            bool result      = thermal2.update();
+            cpu_ns += nowNs() - s;
+            ++calls;
+            // Calls that returned a subpage, and calls that only polled.
+            add(result ? frame_sum : poll_sum,
+                diff(sim.getTotalTraffic(), before));
+            if (result) {
+                ++ok;
+            } else {
+                delay(1);
+            }
+        }
+        traffic_t all = diff(sim.getTotalTraffic(), t0);
+        double sec    = (hostMicros64() - start_us) / 1000000.0;
+
+        printf(
+            "profile %s  refresh rate %d (%.1f Hz)  pixel clock %u Hz  "
+            "frames %u\n",
+            profile_name[p], rate, 1000000.0 / sim.getFramePeriodMicros(),
+            freq, ok);
+        print("update() per frame", frame_sum, ok);
+        print("polling per frame", poll_sum, ok);
+        printf(
+            "%-28s %.2f calls/frame  %.0f ns cpu/call  %.2f fps  missed %u\n",
+            "", (double)calls / ok, cpu_ns / calls, ok / sec,
+            sim.getFramesMissed() - missed0);
+        printf("%-28s %.1f %%  saved %.2f transactions/frame\n",
+               "bus utilisation", all.bus_time_ns / 1e7 / sec,
+               (double)(thermal2.getSavedTransactions() - saved0) / ok);
+    }
+    thermal2.setAcquisitionProfile(M5_Thermal2::profile_full);
+
+    // Non-blocking: the longest time a single poll() keeps the caller.
+    uint32_t async_ok = 0, polls = 0;
+    uint64_t longest_us = 0;
+    while (async_ok < want) {
+        if (!thermal2.isUpdating()) {
+            thermal2.beginUpdate();
+        }
+        uint64_t s  = hostMicros64();
+        auto state  = thermal2.poll();
+        uint64_t us = hostMicros64() - s;
+        ++polls;
+        if (longest_us < us) longest_us = us;
+        if (state == M5_Thermal2::update_done) {
+            ++async_ok;
+        } else if (state == M5_Thermal2::update_failed) {
+            delay(1);
+        }
+    }
+    printf("%-28s %.2f polls/frame  longest poll %u us\n",
+           "beginUpdate()/poll()", (double)polls / async_ok,
+           (unsigned)longest_us);
+    return 0;
+}
@@ -0,0 +1,48 @@
+// Helpers shared by the host benchmarks.
+
+#ifndef BENCH_UTIL_H_
+#define BENCH_UTIL_H_
+
+#include <Wire.h>
+#include <chrono>
+
+#include "M5_Thermal2.h"
+#include "M5_Thermal2_Simulator.h"
+
+/// Host time, for the CPU cost of the code under test. (nsec)
+static inline double nowNs(void) {
+    return std::chrono::duration<double, std::nano>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/// A simulated unit attached to Wire, and the library talking to it.
+/// Detached from Wire when destroyed, so one bench can run several.
+struct bench_unit_t {
+    M5_Thermal2_Simulator sim;
+    M5_Thermal2 thermal2;
+
+    bench_unit_t(M5_Thermal2::refresh_rate_t rate, uint32_t freq = 400000,
+                 uint32_t freq_pixelread = 1000000)
+        : sim(&Wire) {
+        Wire.attach(&sim);
+        Wire.begin();
+        thermal2.begin(&Wire, M5_Thermal2::i2c_default_addr, freq,
+                       freq_pixelread);
+        thermal2.setRefreshRate(rate);
+    }
+    ~bench_unit_t() {
+        Wire.detach(&sim);
+    }
+
+    /// Read the next subpage, sleeping 100 usec while none is ready.
+    void next(M5_Thermal2::temperature_data_t& data) {
+        while (!thermal2.update(data)) delayMicroseconds(100);
+    }
+    /// Same, into getTemperatureData().
+    void next(void) {
+        while (!thermal2.update()) delayMicroseconds(100);
+    }
+};
+
+#endif
@@ -0,0 +1,87 @@
+/*!
+ * @brief Minimal Arduino core stand-in for building M5_Thermal2 on a host.
+ * @copyright Copyright (c) 2022 by M5Stack[https://m5stack.com]
+ *
+ * Only what the library and its host tools use is provided.
+ * Time is virtual: it advances only through delay(), delayMicroseconds()
+ * and simulated bus traffic, so runs are deterministic.
+ */
+#ifndef _M5_THERMAL2_HOST_ARDUINO_H_
+#define _M5_THERMAL2_HOST_ARDUINO_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+using std::max;
+using std::min;
+
+/// Current virtual time in microseconds. (64bit, never wraps)
+uint64_t hostMicros64(void);
+
+/// Advance the virtual clock.
+void hostAdvanceMicros(uint64_t usec);
+
+inline uint32_t micros(void) {
+    return (uint32_t)hostMicros64();
+}
+
+inline uint32_t millis(void) {
+    return (uint32_t)(hostMicros64() / 1000u);
+}
+
+inline void delay(uint32_t msec) {
+    hostAdvanceMicros((uint64_t)msec * 1000u);
+}
+
+inline void delayMicroseconds(uint32_t usec) {
+    hostAdvanceMicros(usec);
+}
+
+inline void yield(void) {
+}
+
+class Print {
+   public:
+    virtual ~Print() {
+    }
+    virtual size_t write(uint8_t) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (size--) {
+            if (!write(*buffer++)) break;
+            ++n;
+        }
+        return n;
+    }
+    size_t write(const char* str) {
+        return str ? write((const uint8_t*)str, strlen(str)) : 0;
+    }
+};
+
+class Stream : public Print {
+   public:
+    virtual int available(void) = 0;
+    virtual int read(void)      = 0;
+    virtual int peek(void)      = 0;
+
+    virtual size_t readBytes(uint8_t* buffer, size_t length) {
+        size_t count = 0;
+        while (count < length) {
+            int c = read();
+            if (c < 0) break;
+            *buffer++ = (uint8_t)c;
+            ++count;
+        }
+        return count;
+    }
+    size_t readBytes(char* buffer, size_t length) {
+        return readBytes((uint8_t*)buffer, length);
+    }
+};
+
+#endif
@@ -0,0 +1,110 @@
+#include "Wire.h"
+
+static uint64_t s_host_time_us = 0;
+
+uint64_t hostMicros64(void) {
+    return s_host_time_us;
+}
+
+void hostAdvanceMicros(uint64_t usec) {
+    s_host_time_us += usec;
+}
+
+TwoWire Wire;
+
+// Carry of sub-microsecond bus time, so short transfers are not lost.
+static uint32_t s_time_remainder_ns = 0;
+
+uint64_t TwoWire::transferTimeNs(size_t bytes) const {
+    // START + address byte + data bytes (8bit + ACK each) + STOP.
+    uint64_t bits = (uint64_t)(bytes + 1) * 9 + 2;
+    return bits * 1000000000u / (_clock ? _clock : 100000u) + _overhead_ns;
+}
+
+void TwoWire::_charge(size_t bytes) {
+    uint64_t ns = transferTimeNs(bytes);
+    _stats.bus_time_ns += ns;
+    ++_stats.transactions;
+
+    ns += s_time_remainder_ns;
+    s_time_remainder_ns = ns % 1000u;
+    hostAdvanceMicros(ns / 1000u);
+}
+
+i2c_device_t* TwoWire::_find(uint16_t address) const {
+    for (auto dev : _devices) {
+        if (dev && dev->i2cAddress() == address) return dev;
+    }
+    return nullptr;
+}
+
+bool TwoWire::attach(i2c_device_t* device) {
+    for (auto& dev : _devices) {
+        if (dev == nullptr) {
+            dev = device;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TwoWire::detach(i2c_device_t* device) {
+    for (auto& dev : _devices) {
+        if (dev == device) dev = nullptr;
+    }
+}
+
+void TwoWire::beginTransmission(uint16_t address) {
+    _tx_addr = address;
+    _tx_len  = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    if (_tx_len >= buffer_length) return 0;
+    _tx_buf[_tx_len++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t length) {
+    size_t n = 0;
+    while (n < length && write(data[n])) ++n;
+    return n;
+}
+
+uint8_t TwoWire::endTransmission(bool) {
+    ++_stats.write_transactions;
+    _stats.bytes_written += _tx_len;
+    _charge(_tx_len);
+    auto dev = _find(_tx_addr);
+    if (dev == nullptr || !dev->i2cWrite(_tx_buf, _tx_len)) {
+        ++_stats.nacks;
+        return 2;  // NACK on address / data.
+    }
+    return 0;
+}
+
+size_t TwoWire::requestFrom(uint16_t address, size_t size, bool) {
+    _rx_pos = 0;
+    _rx_len = 0;
+    if (size > buffer_length) size = buffer_length;
+    ++_stats.read_transactions;
+    auto dev = _find(address);
+    size_t n = dev ? dev->i2cRead(_rx_buf, size) : 0;
+    _charge(dev ? size : 0);
+    if (n < size) {
+        ++_stats.short_reads;
+        // The driver discards a transfer that did not complete.
+        n = 0;
+    }
+    _stats.bytes_read += n;
+    _rx_len = n;
+    return n;
+}
+
+size_t TwoWire::readBytes(uint8_t* buffer, size_t length) {
+    size_t n = _rx_len - _rx_pos;
+    if (n > length) n = length;
+    memcpy(buffer, &_rx_buf[_rx_pos], n);
+    _rx_pos += n;
+    return n;
+}
@@ -0,0 +1,118 @@
+/*!
+ * @brief TwoWire stand-in for building M5_Thermal2 on a host.
+ * @copyright Copyright (c) 2022 by M5Stack[https://m5stack.com]
+ *
+ * Transfers are routed to attached i2c_device_t instances instead of a real
+ * bus. Every transaction is counted and charged to the virtual clock with the
+ * time it would take on the wire at the current clock, so the cost of
+ * M5_Thermal2::update() can be measured without hardware.
+ */
+#ifndef _M5_THERMAL2_HOST_WIRE_H_
+#define _M5_THERMAL2_HOST_WIRE_H_
+
+#include "Arduino.h"
+
+/// Device side of the stand-in bus.
+struct i2c_device_t {
+    virtual ~i2c_device_t() {
+    }
+    /// 7bit address the device answers to.
+    virtual uint16_t i2cAddress(void) const = 0;
+
+    /// Write transaction. (register index followed by payload)
+    /// @return true:ACK / false:NACK
+    virtual bool i2cWrite(const uint8_t* data, size_t length) = 0;
+
+    /// Read transaction.
+    /// @return Number of bytes actually delivered. (less than length = short)
+    virtual size_t i2cRead(uint8_t* data, size_t length) = 0;
+};
+
+class TwoWire : public Stream {
+   public:
+    static constexpr size_t buffer_length = 128;  // Same as arduino-esp32.
+
+    struct bus_stats_t {
+        uint32_t transactions;
+        uint32_t write_transactions;
+        uint32_t read_transactions;
+        uint32_t nacks;
+        uint32_t short_reads;
+        uint32_t set_clock_calls;
+        uint64_t bytes_written;
+        uint64_t bytes_read;
+        uint64_t bus_time_ns;
+    };
+
+    bool begin(void) {
+        return true;
+    }
+
+    bool setClock(uint32_t freq) {
+        ++_stats.set_clock_calls;
+        _clock = freq;
+        return true;
+    }
+    uint32_t getClock(void) const {
+        return _clock;
+    }
+
+    void beginTransmission(uint16_t address);
+    size_t write(uint8_t data) override;
+    size_t write(const uint8_t* data, size_t length) override;
+    uint8_t endTransmission(bool sendStop = true);
+
+    size_t requestFrom(uint16_t address, size_t size, bool sendStop = true);
+
+    int available(void) override {
+        return _rx_len - _rx_pos;
+    }
+    int read(void) override {
+        return (_rx_pos < _rx_len) ? _rx_buf[_rx_pos++] : -1;
+    }
+    int peek(void) override {
+        return (_rx_pos < _rx_len) ? _rx_buf[_rx_pos] : -1;
+    }
+    size_t readBytes(uint8_t* buffer, size_t length) override;
+    using Stream::readBytes;
+
+    /// Attach a simulated device. (up to max_devices)
+    bool attach(i2c_device_t* device);
+    void detach(i2c_device_t* device);
+
+    /// Fixed cost added to every transaction (driver / ISR latency).
+    void setTransactionOverheadMicros(uint32_t usec) {
+        _overhead_ns = usec * 1000u;
+    }
+
+    /// Time a transaction of `bytes` data bytes occupies the bus.
+    uint64_t transferTimeNs(size_t bytes) const;
+
+    const bus_stats_t& getStats(void) const {
+        return _stats;
+    }
+    void resetStats(void) {
+        _stats = bus_stats_t{};
+    }
+
+   private:
+    static constexpr size_t max_devices = 8;
+
+    i2c_device_t* _find(uint16_t address) const;
+    void _charge(size_t bytes);
+
+    i2c_device_t* _devices[max_devices] = {};
+    uint32_t _clock                     = 100000;
+    uint32_t _overhead_ns               = 20000;
+    uint16_t _tx_addr                   = 0;
+    size_t _tx_len                      = 0;
+    size_t _rx_len                      = 0;
+    size_t _rx_pos                      = 0;
+    uint8_t _tx_buf[buffer_length];
+    uint8_t _rx_buf[buffer_length];
+    bus_stats_t _stats = {};
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,261 @@
+#include "M5_Thermal2_Simulator.h"
+
+#include <math.h>
+
+M5_Thermal2_Simulator::M5_Thermal2_Simulator(TwoWire* wire, uint8_t i2c_addr)
+    : _wire{wire}, _addr{i2c_addr} {
+    memset(&_reg, 0, sizeof(_reg));
+    _reg.status.device_id_0   = M5_Thermal2::reg_device_id_0;
+    _reg.status.device_id_1   = M5_Thermal2::reg_device_id_1;
+    _reg.status.version_major = 1;
+    _reg.status.version_minor = 0;
+
+    _reg.config.i2c_addr          = i2c_addr;
+    _reg.config.i2c_addr_inv      = ~i2c_addr;
+    _reg.config.refresh_rate      = M5_Thermal2::rate_16Hz;
+    _reg.config.temp_monitor_area = 15 | 11 << 4;
+    _reg.config.buzzer_freq       = 2000;
+    _reg.config.buzzer_volume     = 64;
+
+    _reg.lowest_alarm.temp_threshold   = M5_Thermal2::convertCelsiusToRaw(0);
+    _reg.lowest_alarm.buzzer_interval  = 25;
+    _reg.highest_alarm.temp_threshold  = M5_Thermal2::convertCelsiusToRaw(50);
+    _reg.highest_alarm.buzzer_interval = 25;
+
+    memset(&_overview, 0, sizeof(_overview));
+    memset(_pixel, 0, sizeof(_pixel));
+    uint16_t ambient = M5_Thermal2::convertCelsiusToRaw(25.0f);
+    for (auto& s : _scene) s = ambient;
+    memcpy(_prev_scene, _scene, sizeof(_prev_scene));
+
+    // UnitThermal2 takes more than 100msec to start up.
+    _boot_until_us = hostMicros64() + 120000u;
+    _next_frame_us = _boot_until_us + getFramePeriodMicros();
+}
+
+void M5_Thermal2_Simulator::setButton(bool pressed) {
+    auto& btn = _reg.status.button;
+    if (pressed && !(btn & M5_Thermal2::button_is_pressed)) {
+        btn |= M5_Thermal2::button_is_pressed | M5_Thermal2::button_was_pressed;
+    } else if (!pressed && (btn & M5_Thermal2::button_is_pressed)) {
+        btn &= ~M5_Thermal2::button_is_pressed;
+        btn |=
+            M5_Thermal2::button_was_released | M5_Thermal2::button_was_clicked;
+    }
+}
+
+void M5_Thermal2_Simulator::resetTraffic(void) {
+    _total                = traffic_t{};
+    _frame                = traffic_t{};
+    _last_frame           = traffic_t{};
+    _config_bytes_written = 0;
+}
+
+uint16_t M5_Thermal2_Simulator::_random(void) {
+    _lcg = _lcg * 1664525u + 1013904223u;
+    return _lcg >> 16;
+}
+
+bool M5_Thermal2_Simulator::_injectFault(void) {
+    if (_pixel_error_ppm == 0) return false;
+    // Separate generator, so faults do not change the scene.
+    _fault_lcg = _fault_lcg * 1664525u + 1013904223u;
+    return (_fault_lcg >> 8) % 1000000u < _pixel_error_ppm;
+}
+
+void M5_Thermal2_Simulator::_account(bool is_write, size_t bytes) {
+    uint64_t ns = _wire->transferTimeNs(bytes);
+    for (auto t : {&_total, &_frame}) {
+        ++t->transactions;
+        if (is_write) {
+            ++t->write_transactions;
+            t->bytes_written += bytes;
+        } else {
+            ++t->read_transactions;
+            t->bytes_read += bytes;
+        }
+        t->bus_time_ns += ns;
+    }
+}
+
+void M5_Thermal2_Simulator::_advance(void) {
+    uint64_t now = hostMicros64();
+    if (now < _next_frame_us) return;
+
+    uint32_t period = getFramePeriodMicros();
+    uint32_t behind = (now - _next_frame_us) / period;
+    if (behind) {
+        // Subpages that nobody could have read; only the newest one matters.
+        _frames_generated += behind;
+        _frames_missed += behind;
+        _refresh_control[1] ^= behind & 1;
+    }
+    _frame_us = _next_frame_us + (uint64_t)behind * period;
+    _generate();
+    _next_frame_us += (uint64_t)(behind + 1) * period;
+}
+
+void M5_Thermal2_Simulator::_generate(void) {
+    float t  = (float)hostMicros64() / 1000000.0f;
+    float hx = 15.5f + 8.0f * cosf(t);
+    float hy = 11.5f + 6.0f * sinf(t);
+
+    bool subpage = !_refresh_control[1];
+    for (int idx = 0; idx < 384; ++idx) {
+        int y    = idx >> 4;
+        int x    = ((idx & 15) << 1) + ((y & 1) != subpage);
+        float c  = 22.0f + x * 0.10f + y * 0.05f;
+        float dx = x - hx;
+        float dy = y - hy;
+        float d2 = dx * dx + dy * dy;
+        if (_hot_spot && d2 < 16.0f) {
+            c += 38.0f * (1.0f - d2 / 16.0f);
+        }
+        int raw = M5_Thermal2::convertCelsiusToRaw(c);
+        if (_noise) {
+            raw += (int)(_random() % (2u * _noise + 1)) - _noise;
+        }
+        _pixel[idx]        = raw;
+        _scene[x + y * 32] = raw;
+    }
+
+    // Overview of the monitor area.
+    uint8_t area = _reg.config.temp_monitor_area;
+    int hw       = (area & 15) + 1;
+    int hh       = (area >> 4) + 1;
+    if (hh > 12) hh = 12;
+    int x0 = 16 - hw, x1 = 16 + hw;
+    int y0 = 12 - hh, y1 = 12 + hh;
+
+    uint16_t values[32 * 24];
+    size_t count     = 0;
+    uint32_t sum     = 0;
+    auto& ov         = _overview;
+    ov.lowest_raw    = UINT16_MAX;
+    ov.highest_raw   = 0;
+    ov.most_diff_raw = 0;
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            uint16_t v      = _scene[x + y * 32];
+            values[count++] = v;
+            sum += v;
+            if (ov.lowest_raw > v) {
+                ov.lowest_raw = v;
+                ov.lowest_x   = x;
+                ov.lowest_y   = y;
+            }
+            if (ov.highest_raw < v) {
+                ov.highest_raw = v;
+                ov.highest_x   = x;
+                ov.highest_y   = y;
+            }
+            int diff = abs((int)v - (int)_prev_scene[x + y * 32]);
+            if (ov.most_diff_raw < diff) {
+                ov.most_diff_raw = diff;
+                ov.most_diff_x   = x;
+                ov.most_diff_y   = y;
+            }
+        }
+    }
+    std::nth_element(values, values + count / 2, values + count);
+    ov.median_raw  = values[count / 2];
+    ov.average_raw = sum / count;
+    memcpy(_prev_scene, _scene, sizeof(_prev_scene));
+
+    ++_frames_generated;
+    if (_refresh_control[0] & 1) {
+        ++_frames_missed;
+    }
+    _refresh_control[0] |= 1;
+    _refresh_control[1] = subpage;
+}
+
+uint8_t M5_Thermal2_Simulator::_readByte(uint16_t index) const {
+    if (index < sizeof(_reg)) {
+        return ((const uint8_t*)&_reg)[index];
+    }
+    if (index >= M5_Thermal2::reg_index_refresh_control &&
+        index < M5_Thermal2::reg_index_overview) {
+        return _refresh_control[index - M5_Thermal2::reg_index_refresh_control];
+    }
+    if (index >= M5_Thermal2::reg_index_overview &&
+        index < reg_index_pixel_begin) {
+        return ((const uint8_t*)&_overview)[index -
+                                            M5_Thermal2::reg_index_overview];
+    }
+    if (index >= reg_index_pixel_begin && index < reg_index_pixel_end) {
+        return ((const uint8_t*)_pixel)[index - reg_index_pixel_begin];
+    }
+    return 0;
+}
+
+void M5_Thermal2_Simulator::_writeByte(uint16_t index, uint8_t value) {
+    auto reg = (uint8_t*)&_reg;
+    if (index == M5_Thermal2::reg_index_status) {
+        // Writing a flag clears it. (bit 0 is the live state)
+        _reg.status.button &= ~(value & ~1u);
+    } else if (index >= M5_Thermal2::reg_index_config &&
+               index < M5_Thermal2::reg_index_config +
+                           sizeof(M5_Thermal2::config_reg_t)) {
+        ++_config_bytes_written;
+        uint8_t prev = reg[index];
+        reg[index]   = value;
+        if (&reg[index] == (uint8_t*)&_reg.config.refresh_rate &&
+            prev != value) {
+            _next_frame_us = hostMicros64() + getFramePeriodMicros();
+        }
+    } else if ((index >= M5_Thermal2::reg_index_lowest_alarm &&
+                index < M5_Thermal2::reg_index_lowest_alarm +
+                            sizeof(M5_Thermal2::alarm_reg_t)) ||
+               (index >= M5_Thermal2::reg_index_highest_alarm &&
+                index < M5_Thermal2::reg_index_highest_alarm +
+                            sizeof(M5_Thermal2::alarm_reg_t))) {
+        ++_config_bytes_written;
+        reg[index] = value;
+    } else if (index == M5_Thermal2::reg_index_refresh_control) {
+        _refresh_control[0] = value;
+    }
+}
+
+bool M5_Thermal2_Simulator::i2cWrite(const uint8_t* data, size_t length) {
+    if (hostMicros64() < _boot_until_us) return false;
+    _advance();
+    _account(true, length);
+    if (length == 0) return true;
+
+    _pointer = data[0];
+    for (size_t i = 1; i < length; ++i) {
+        _writeByte(_pointer++, data[i]);
+    }
+    return true;
+}
+
+size_t M5_Thermal2_Simulator::i2cRead(uint8_t* data, size_t length) {
+    if (hostMicros64() < _boot_until_us) return 0;
+    _advance();
+    _account(false, length);
+
+    if (_pointer >= reg_index_pixel_begin && _pointer < reg_index_pixel_end &&
+        _injectFault()) {
+        // The transfer breaks off part way. The unit has already advanced
+        // over the bytes it sent.
+        ++_pixel_errors;
+        length = (_fault_lcg >> 4) % length;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        data[i] = _readByte(_pointer);
+        if (_pointer < reg_index_pixel_end) {
+            ++_pointer;
+            if (_pointer == reg_index_pixel_end) {
+                // The whole pixel stream was read.
+                if (_reg.config.function_ctrl & 0x04) {
+                    _refresh_control[0] &= ~1u;
+                }
+                ++_frames_read;
+                _last_frame = _frame;
+                _frame      = traffic_t{};
+            }
+        }
+    }
+    return length;
+}
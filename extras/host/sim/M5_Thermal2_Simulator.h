@@ -0,0 +1,160 @@
+/*!
+ * @brief Register-level simulator of the Unit Thermal2 for host builds.
+ * @copyright Copyright (c) 2022 by M5Stack[https://m5stack.com]
+ *
+ * Emulates the register map used by M5_Thermal2:
+ *   0x00~0x07 status / 0x08~0x17 config / 0x20,0x30 alarm blocks
+ *   0x6E refresh control (ready flag, subpage) / 0x70 overview
+ *   0x80~0x37F pixel stream (384 x uint16, one checkerboard subpage)
+ * A synthetic scene (gradient background and an orbiting hot spot) produces a
+ * new subpage every refresh period of the configured refresh_rate_t.
+ */
+#ifndef _M5_THERMAL2_SIMULATOR_H_
+#define _M5_THERMAL2_SIMULATOR_H_
+
+#include <Wire.h>
+
+#include "M5_Thermal2.h"
+
+class M5_Thermal2_Simulator : public i2c_device_t {
+   public:
+    static constexpr uint16_t reg_index_pixel_begin = 0x80;
+    static constexpr uint16_t reg_index_pixel_end   = 0x80 + 768;
+
+    /// Bus traffic addressed to the simulated unit.
+    struct traffic_t {
+        uint32_t transactions;
+        uint32_t write_transactions;
+        uint32_t read_transactions;
+        uint32_t bytes_written;
+        uint32_t bytes_read;
+        uint64_t bus_time_ns;
+    };
+
+    M5_Thermal2_Simulator(TwoWire* wire,
+                          uint8_t i2c_addr = M5_Thermal2::i2c_default_addr);
+
+    uint16_t i2cAddress(void) const override {
+        return _addr;
+    }
+    bool i2cWrite(const uint8_t* data, size_t length) override;
+    size_t i2cRead(uint8_t* data, size_t length) override;
+
+    /// Time needed after construction before the unit answers. (usec)
+    void setBootTime(uint32_t usec) {
+        _boot_until_us = hostMicros64() + usec;
+    }
+
+    /// Amplitude of the per-pixel noise added to the scene. (raw units)
+    void setNoise(uint16_t raw_amplitude) {
+        _noise = raw_amplitude;
+    }
+
+    /// Enable or disable the orbiting hot spot.
+    void setHotSpot(bool enable) {
+        _hot_spot = enable;
+    }
+
+    /// Probability (per million) that a read inside the pixel stream is cut
+    /// short, as happens when running the bus above 400kHz.
+    void setPixelReadErrorRate(uint32_t per_million) {
+        _pixel_error_ppm = per_million;
+    }
+    /// Pixel stream reads cut short so far.
+    inline uint32_t getPixelReadErrors(void) const {
+        return _pixel_errors;
+    }
+
+    /// Simulate the button. (sets the same flags as the real unit)
+    void setButton(bool pressed);
+
+    inline M5_Thermal2::refresh_rate_t getRefreshRate(void) const {
+        return (M5_Thermal2::refresh_rate_t)(_reg.config.refresh_rate & 7);
+    }
+    /// Deviation of the unit's clock from nominal. (ppm, + = slower)
+    void setClockSkewPpm(int32_t ppm) {
+        _skew_ppm = ppm;
+    }
+    /// Subpage period of the current refresh rate. (usec)
+    inline uint32_t getFramePeriodMicros(void) const {
+        uint64_t period = 2000000u >> getRefreshRate();
+        return period * (1000000 + _skew_ppm) / 1000000;
+    }
+    /// Time the current subpage became ready. (usec)
+    inline uint64_t getLastFrameMicros(void) const {
+        return _frame_us;
+    }
+
+    /// Subpages produced so far.
+    inline uint32_t getFramesGenerated(void) const {
+        return _frames_generated;
+    }
+    /// Subpages whose pixel stream was read to the end.
+    inline uint32_t getFramesRead(void) const {
+        return _frames_read;
+    }
+    /// Subpages overwritten before they were read.
+    inline uint32_t getFramesMissed(void) const {
+        return _frames_missed;
+    }
+
+    /// Traffic since construction / resetTraffic().
+    inline const traffic_t& getTotalTraffic(void) const {
+        return _total;
+    }
+    /// Traffic spent to acquire the most recently completed frame.
+    inline const traffic_t& getLastFrameTraffic(void) const {
+        return _last_frame;
+    }
+    /// Bytes written into the config and alarm blocks. (0x08~0x37)
+    inline uint32_t getConfigBytesWritten(void) const {
+        return _config_bytes_written;
+    }
+    void resetTraffic(void);
+
+    /// Ground truth of the scene. (32x24, row major)
+    inline const uint16_t* getScene(void) const {
+        return _scene;
+    }
+
+   private:
+    void _advance(void);
+    void _generate(void);
+    void _account(bool is_write, size_t bytes);
+    uint8_t _readByte(uint16_t index) const;
+    void _writeByte(uint16_t index, uint8_t value);
+    uint16_t _random(void);
+    bool _injectFault(void);
+
+    TwoWire* _wire;
+    uint8_t _addr;
+    uint16_t _pointer = 0;
+    uint16_t _noise   = 24;
+    bool _hot_spot    = true;
+
+    uint64_t _boot_until_us;
+    uint64_t _next_frame_us;
+    uint64_t _frame_us        = 0;
+    int32_t _skew_ppm         = 0;
+    uint32_t _lcg             = 0x12345678u;
+    uint32_t _fault_lcg       = 0x9E3779B9u;
+    uint32_t _pixel_error_ppm = 0;
+    uint32_t _pixel_errors    = 0;
+
+    uint32_t _frames_generated     = 0;
+    uint32_t _frames_read          = 0;
+    uint32_t _frames_missed        = 0;
+    uint32_t _config_bytes_written = 0;
+    traffic_t _total               = {};
+    traffic_t _frame               = {};
+    traffic_t _last_frame          = {};
+
+    M5_Thermal2::unit_thermal2_reg_t _reg;
+    uint8_t _refresh_control[2] = {0, 0};
+    M5_Thermal2::temperature_reg_t _overview;
+    uint16_t _pixel[384];
+    uint16_t _scene[32 * 24];
+    uint16_t _prev_scene[32 * 24];
+};
+
+#endif
@@ -7,10 +7,14 @@ class i2c_clock_changer {
    public:
     i2c_clock_changer(TwoWire* wire, uint32_t freq) : _wire{wire} {
         _prev_freq = wire->getClock();
-        wire->setClock(freq);
+        if (_prev_freq != freq) {
+            wire->setClock(freq);
+        }
     }
     ~i2c_clock_changer() {
-        _wire->setClock(_prev_freq);
+        if (_wire->getClock() != _prev_freq) {
+            _wire->setClock(_prev_freq);
+        }
     }
 };
 
@@ -36,6 +40,12 @@ void M5_Thermal2::setI2CFreq(uint32_t freq, uint32_t freq_pixelread) {
     _freq_pixelread = (_freq > freq_pixelread) ? _freq : freq_pixelread;
 }
 
+void M5_Thermal2::setPixelRows(uint8_t rows) {
+    if (rows < 1) rows = 1;
+    if (rows > frame_height) rows = frame_height;
+    _pixel_rows = rows;
+}
+
 bool M5_Thermal2::_checkInit(void) {
     if (_init_step > 1) return true;
 
@@ -50,11 +60,14 @@ bool M5_Thermal2::_checkInit(void) {
         _wire->readBytes((uint8_t*)&reg, sizeof(unit_thermal2_reg_t));
         if (reg.status.device_id_0 == reg_device_id_0 &&
             reg.status.device_id_1 == reg_device_id_1) {
-            _init_step     = 2;
-            _status        = reg.status;
-            _config        = reg.config;
-            _lowest_alarm  = reg.lowest_alarm;
-            _highest_alarm = reg.highest_alarm;
+            _init_step             = 2;
+            _status                = reg.status;
+            _config                = reg.config;
+            _lowest_alarm          = reg.lowest_alarm;
+            _highest_alarm         = reg.highest_alarm;
+            _written_config        = reg.config;
+            _written_lowest_alarm  = reg.lowest_alarm;
+            _written_highest_alarm = reg.highest_alarm;
 
             if (!(_config.function_ctrl & 0x04)) {
                 _config.function_ctrl |= 0x04;
@@ -64,80 +77,489 @@ bool M5_Thermal2::_checkInit(void) {
     return (_init_step > 1);
 }
 
+// Byte offsets the register fields start at, a bit each. A write never
+// splits a field: the unit would act on a half-written buzzer frequency or
+// threshold, and checks i2c_addr against i2c_addr_inv.
+static constexpr uint32_t field_bit(size_t offset) {
+    return 1u << offset;
+}
+static constexpr uint32_t config_fields =
+    field_bit(offsetof(M5_Thermal2::config_reg_t, i2c_addr)) |  // + inv
+    field_bit(offsetof(M5_Thermal2::config_reg_t, function_ctrl)) |
+    field_bit(offsetof(M5_Thermal2::config_reg_t, refresh_rate)) |
+    field_bit(offsetof(M5_Thermal2::config_reg_t, noise_filter)) |
+    field_bit(offsetof(M5_Thermal2::config_reg_t, reserved_0x0D)) |
+    field_bit(offsetof(M5_Thermal2::config_reg_t, reserved_0x0E)) |
+    field_bit(offsetof(M5_Thermal2::config_reg_t, temp_monitor_area)) |
+    field_bit(offsetof(M5_Thermal2::config_reg_t, temp_alarm_enable)) |
+    field_bit(offsetof(M5_Thermal2::config_reg_t, buzzer_freq)) |
+    field_bit(offsetof(M5_Thermal2::config_reg_t, buzzer_volume)) |
+    field_bit(offsetof(M5_Thermal2::config_reg_t, led));
+static constexpr uint32_t alarm_fields =
+    field_bit(offsetof(M5_Thermal2::alarm_reg_t, temp_threshold)) |
+    field_bit(offsetof(M5_Thermal2::alarm_reg_t, buzzer_freq)) |
+    field_bit(offsetof(M5_Thermal2::alarm_reg_t, buzzer_interval)) |
+    field_bit(offsetof(M5_Thermal2::alarm_reg_t, led));
+
+bool M5_Thermal2::_writeDirty(uint8_t reg_index, const void* shadow,
+                              void* written, size_t len,
+                              uint32_t field_starts) {
+    // A gap of unchanged bytes up to this size is cheaper to rewrite than to
+    // start another transaction for. (address + register index + START/STOP)
+    static constexpr size_t merge_gap = 4;
+
+    auto src = (const uint8_t*)shadow;
+    auto dst = (uint8_t*)written;
+    size_t i = 0;
+    for (;;) {
+        while (i < len && src[i] == dst[i]) ++i;
+        if (i == len) return true;
+        size_t begin = i;
+        size_t end   = i + 1;
+        for (i = end; i < len && i - end <= merge_gap; ++i) {
+            if (src[i] != dst[i]) end = i + 1;
+        }
+        // Widen to whole fields.
+        while (!((field_starts >> begin) & 1)) --begin;
+        while (end < len && !((field_starts >> end) & 1)) ++end;
+        i = end;
+
+        _wire->beginTransmission(_addr);
+        _wire->write(reg_index + begin);
+        _wire->write(&src[begin], end - begin);
+        if (0 != _wire->endTransmission()) return false;
+        memcpy(&dst[begin], &src[begin], end - begin);
+    }
+}
+
 bool M5_Thermal2::_updateConfig(void) {
+    if (_config_batch_depth) return true;
     if (!_checkInit()) return false;
 
     i2c_clock_changer i2cc = {_wire, _freq};
 
-    _wire->beginTransmission(_addr);
-    _wire->write(reg_index_config);
-    _wire->write((uint8_t*)&_config, sizeof(_config));
-    _init_step = (0 == _wire->endTransmission()) ? 2 : 1;
-    return (_init_step > 1);
+    bool result =
+        _writeDirty(reg_index_config, &_config, &_written_config,
+                    sizeof(_config), config_fields) &&
+        _writeDirty(reg_index_lowest_alarm, &_lowest_alarm,
+                    &_written_lowest_alarm, sizeof(_lowest_alarm),
+                    alarm_fields) &&
+        _writeDirty(reg_index_highest_alarm, &_highest_alarm,
+                    &_written_highest_alarm, sizeof(_highest_alarm),
+                    alarm_fields);
+    _init_step = result ? 2 : 1;
+    return result;
+}
+
+void M5_Thermal2::beginConfig(void) {
+    ++_config_batch_depth;
+}
+
+bool M5_Thermal2::commit(void) {
+    if (_config_batch_depth && --_config_batch_depth) return true;
+    return _updateConfig();
 }
 
 bool M5_Thermal2::update(void) {
-    if (!_checkInit()) return false;
+    return update(_latest_raw);
+}
 
+bool M5_Thermal2::update(temperature_data_t& dst) {
+    if (!beginUpdate(dst)) {
+        // The pending update is left to poll(); its buffer may not be dst.
+        _fail(failure_busy);
+        return false;
+    }
+
+    // Hold the bus clock for the whole sequence and only switch it when the
+    // phase requires another speed.
     i2c_clock_changer i2cc = {_wire, _freq};
 
-    _wire->beginTransmission(_addr);
-    _wire->write(reg_index_status);
-    if (0 != _wire->endTransmission(false)) return 0;
-    if (2u == _wire->requestFrom(_addr, 2u)) {
-        _wire->readBytes((uint8_t*)&_status, 2);
-        if (_status.button & ~1u) {
+    update_state_t state;
+    do {
+        uint32_t freq = _phaseFreq();
+        if (_wire->getClock() != freq) {
+            _wire->setClock(freq);
+        }
+        state = _updateStep();
+    } while (state == update_busy);
+    return state == update_done;
+}
+
+bool M5_Thermal2::beginUpdate(void) {
+    // A staging buffer is published by _publish() when done.
+    return beginUpdate(_staging ? *_staging : _latest_raw);
+}
+
+bool M5_Thermal2::setStagingBuffer(temperature_data_t* buffer) {
+    if (_update_phase != phase_idle) return false;
+    _staging = buffer;
+    return true;
+}
+
+bool M5_Thermal2::beginUpdate(temperature_data_t& dst) {
+    if (_update_phase != phase_idle) return false;
+    _update_dst       = &dst;
+    _update_rows      = _pixel_rows;  // later changes wait for the next.
+    _update_phase     = (_init_step > 1) ? _firstPhase() : phase_init;
+    _restart_left     = _pixel_restart;
+    _failed_chunks    = 0;
+    _pixel_read_accum = 0;
+    return true;
+}
+
+M5_Thermal2::update_state_t M5_Thermal2::poll(void) {
+    if (_update_phase == phase_idle) return update_idle;
+
+    i2c_clock_changer i2cc = {_wire, _phaseFreq()};
+    return _updateStep();
+}
+
+#if defined(M5_THERMAL2_ENABLE_STATS)
+M5_Thermal2::update_state_t M5_Thermal2::_updateStep(void) {
+    update_phase_t phase = _update_phase;
+    uint8_t chunk        = _pixel_chunk;
+    uint32_t usec        = micros();
+    update_state_t state = _runPhase();
+    uint32_t now         = micros();
+
+    phase_timing_t* timing = nullptr;
+    switch (phase) {
+        default:
+            break;
+        case phase_status:
+        case phase_button_clear:
+            timing = &_stats.status;
+            break;
+        case phase_refresh_control:
+            timing = &_stats.refresh_control;
+            break;
+        case phase_overview:
+            timing = &_stats.overview;
+            break;
+        case phase_pixel:
+            timing = &_stats.pixel_chunk[chunk];
+            break;
+        case phase_pixel_restart:
+            timing = &_stats.pixel_restart;
+            break;
+        case phase_ack:
+            timing = &_stats.ack;
+            break;
+    }
+    if (timing) {
+        usec              = now - usec;
+        timing->last_usec = usec;
+        if (timing->max_usec < usec) timing->max_usec = usec;
+        timing->total_usec += usec;
+        ++timing->count;
+    }
+
+    if (state == update_done) {
+        uint8_t subpage = _update_dst->subpage;
+        if (_stats.frame_seq) {
+            // Subpages alternate, so the parity of the missed count is known
+            // from the subpage. The elapsed time gives the magnitude, at the
+            // rate the unit holds. (not a beginConfig() edit before commit())
+            uint32_t period = 2000000u >> (_written_config.refresh_rate & 7);
+            uint32_t missed = (now - _stats.last_frame_usec + (period >> 1)) /
+                              period;
+            missed          = missed ? missed - 1 : 0;
+            if ((subpage == _stats.last_subpage) != (missed & 1)) {
+                missed = (subpage == _stats.last_subpage) ? missed + 1
+                                                          : missed - 1;
+            }
+            _stats.missed_subpages += missed;
+        }
+        ++_stats.frame_seq;
+        ++_stats.subpage_seq[subpage & 1];
+        _stats.last_frame_usec = now;
+        _stats.last_subpage    = subpage;
+    }
+    return state;
+}
+
+void M5_Thermal2::resetStats(void) {
+    _stats = update_stats_t{};
+}
+#endif
+
+M5_Thermal2::update_state_t M5_Thermal2::_runPhase(void) {
+    static constexpr uint8_t i2c_once_read = 128;
+    static constexpr uint8_t row_bytes     = frame_width;  // 16 x uint16
+
+    update_phase_t phase = _update_phase;
+    _update_phase        = phase_idle;
+
+    switch (phase) {
+        default:
+            return update_idle;
+
+        case phase_init:
+            if (!_checkInit()) return _fail(failure_init);
+            _update_phase = _firstPhase();
+            return update_busy;
+
+        case phase_status:
+            _wire->beginTransmission(_addr);
+            _wire->write(reg_index_status);
+            if (0 != _wire->endTransmission(false)) return _fail(failure_nack);
+            _update_phase = phase_refresh_control;
+            if (2u == _wire->requestFrom(_addr, 2u)) {
+                _wire->readBytes((uint8_t*)&_status, 2);
+                if (_status.button & ~1u) {
+                    _update_phase = phase_button_clear;
+                }
+            }
+            return update_busy;
+
+        case phase_button_clear:
             _wire->beginTransmission(_addr);
             _wire->write(reg_index_status);
             _wire->write(_status.button);
             _wire->endTransmission(true);
+            _update_phase = phase_refresh_control;
+            return update_busy;
+
+        case phase_refresh_control: {
+            if (_profile == profile_pixels_only) {
+                // status read (write + read) skipped.
+                _saved_transactions += 2;
+            }
+            _wire->beginTransmission(_addr);
+            _wire->write(reg_index_refresh_control);
+            if (0 != _wire->endTransmission(false)) return _fail(failure_nack);
+            if (2 != _wire->requestFrom(_addr, 2u, true)) {
+                return _fail(failure_short_read);
+            }
+            int reg_0x6E     = _wire->read();
+            _pending_subpage = _wire->read();
+            bool ready       = (reg_0x6E >= 0) && (reg_0x6E & 1);
+            _observeReady(ready);
+            if (!ready) return _fail(failure_not_ready);
+            if (_profile == profile_pixels_only) {
+                // overview read (write + read) replaced by a seek.
+                _saved_transactions += 1;
+                _update_dst->subpage = _pending_subpage;
+                _pixel_chunk         = 0;
+                _pixel_seek          = true;
+                _update_phase        = phase_pixel;
+                return update_busy;
+            }
+            _update_phase = phase_overview;
+            return update_busy;
         }
-    }
 
-    _wire->beginTransmission(_addr);
-    _wire->write(reg_index_refresh_control);
-    if (0 != _wire->endTransmission(false)) return false;
-    if (2 != _wire->requestFrom(_addr, 2u, true)) return false;
-    int reg_0x6E = _wire->read();
-    bool subpage = _wire->read();
-    if (reg_0x6E < 0 || (0 == (reg_0x6E & 1))) return false;
+        case phase_overview: {
+            _wire->beginTransmission(_addr);
+            _wire->write(reg_index_overview);
+            temperature_reg_t tempreg;
+            if (0 != _wire->endTransmission(true)) return _fail(failure_nack);
+            bool result =
+                (sizeof(temperature_reg_t) ==
+                 _wire->requestFrom(_addr, sizeof(temperature_reg_t))) &&
+                (sizeof(temperature_reg_t) ==
+                 _wire->readBytes((uint8_t*)&(tempreg),
+                                  sizeof(temperature_reg_t)));
+            if (!result) return _fail(failure_short_read);
+            _update_dst->temperature_reg = tempreg;
+            _update_dst->subpage         = _pending_subpage;
+            _pixel_chunk                 = 0;
+            _pixel_seek                  = false;
+            _update_phase                = phase_pixel;
+            return update_busy;
+        }
 
-    _wire->beginTransmission(_addr);
-    _wire->write(reg_index_overview);
-    temperature_reg_t tempreg;
-    bool result =
-        (0 == _wire->endTransmission(true)) &&
-        (sizeof(temperature_reg_t) ==
-         _wire->requestFrom(_addr, sizeof(temperature_reg_t))) &&
-        (sizeof(temperature_reg_t) ==
-         _wire->readBytes((uint8_t*)&(tempreg), sizeof(temperature_reg_t)));
-    if (result) {
-        if (_freq < _freq_pixelread) {
-            _wire->setClock(_freq_pixelread);
+        case phase_pixel: {
+            uint32_t usec = micros();
+            if (_pixel_seek) {
+                _pixel_seek = false;
+                _wire->beginTransmission(_addr);
+                _wire->write(reg_index_pixel);
+                if (0 != _wire->endTransmission(false)) {
+                    return _fail(failure_nack);
+                }
+            }
+            uint16_t total = _update_rows * row_bytes;
+            uint16_t pos   = _pixel_chunk * i2c_once_read;
+            uint8_t len    = (total - pos < i2c_once_read) ? total - pos
+                                                           : i2c_once_read;
+            auto dst       = &((uint8_t*)_update_dst->pixel_raw)[pos];
+            bool result    = (len == _wire->requestFrom(_addr, len)) &&
+                             (len == _wire->readBytes(dst, len));
+            _pixel_read_accum += micros() - usec;
+            if (!result) {
+                _failed_chunks |= 1 << _pixel_chunk;
+                return _restartPixels();
+            }
+            if (_failed_chunks & (1 << _pixel_chunk)) {
+                _failed_chunks &= ~(1 << _pixel_chunk);
+                ++_chunk_recovered;
+            }
+            if (pos + len < total) {
+                ++_pixel_chunk;
+                _update_phase = phase_pixel;
+                return update_busy;
+            }
+            _pixel_read_usec        = _pixel_read_accum;
+            _update_dst->stale_rows = (0xFFFFFFu << _update_rows) & 0xFFFFFFu;
+            _saved_pixel_bytes += (frame_height - _update_rows) * row_bytes;
+            // A partial read leaves the ready flag set.
+            if (0 == (_config.function_ctrl & 0x04) ||
+                _update_rows < frame_height) {
+                _update_phase = phase_ack;
+                return update_busy;
+            }
+            break;
         }
-        _latest_raw.temperature_reg = tempreg;
-        _latest_raw.subpage         = subpage;
-
-        static constexpr uint8_t i2c_once_read = 128;
-        static constexpr uint8_t read_count    = 768 / i2c_once_read;
-
-        auto dst = (uint8_t*)_latest_raw.pixel_raw;
-        for (uint_fast8_t i = 0; result && i < read_count; ++i) {
-            result =
-                (i2c_once_read == _wire->requestFrom(_addr, i2c_once_read)) &&
-                (i2c_once_read == _wire->readBytes(dst, i2c_once_read));
-            dst += i2c_once_read;
+
+        case phase_pixel_restart: {
+            // Make sure the unit still holds the subpage being read.
+            _wire->beginTransmission(_addr);
+            _wire->write(reg_index_refresh_control);
+            if (0 != _wire->endTransmission(false) ||
+                2 != _wire->requestFrom(_addr, 2u, true)) {
+                return _restartPixels();
+            }
+            int reg_0x6E = _wire->read();
+            int subpage  = _wire->read();
+            if (0 == (reg_0x6E & 1) || subpage != _pending_subpage) {
+                return _dropChunks(failure_subpage_changed);
+            }
+            // Only the start of the pixel stream is addressable: the read
+            // restarts from the first chunk.
+            _pixel_chunk  = 0;
+            _pixel_seek   = true;
+            _update_phase = phase_pixel;
+            return update_busy;
         }
+
+        case phase_ack:
+            _wire->beginTransmission(_addr);
+            _wire->write(reg_index_refresh_control);
+            _wire->write(0);
+            if (0 != _wire->endTransmission(true)) return _fail(failure_nack);
+            break;
     }
+    // Without the overview (profile_pixels_only) there is nothing to check
+    // the pixels against.
+    if (_profile == profile_full &&
+        _update_dst->temperature_reg.lowest_raw >=
+            _update_dst->temperature_reg.highest_raw) {
+        return _fail(failure_sanity);
+    }
+    if (_staging && _update_dst == _staging) _publish();
+    return update_done;
+}
 
-    if (result && (0 == (_config.function_ctrl & 0x04))) {
-        _wire->beginTransmission(_addr);
-        _wire->write(reg_index_refresh_control);
-        _wire->write(0);
-        result = (0 == _wire->endTransmission(true));
+void M5_Thermal2::_publish(void) {
+    // Only what this update read; the rest keeps the previous values.
+    if (_profile == profile_full) {
+        _latest_raw.temperature_reg = _staging->temperature_reg;
+    }
+    _latest_raw.subpage    = _staging->subpage;
+    _latest_raw.stale_rows = _staging->stale_rows;
+    memcpy(_latest_raw.pixel_raw, _staging->pixel_raw,
+           _update_rows * (subpage_pixels / frame_height) * sizeof(uint16_t));
+}
+
+// Subpage period of the refresh rate. (usec)
+static inline uint32_t nominal_period(uint8_t rate) {
+    return 2000000u >> (rate & 7);
+}
+
+void M5_Thermal2::_observeReady(bool ready) {
+    uint32_t now = micros();
+    uint8_t rate = _written_config.refresh_rate & 7;
+    if (_predict_rate != rate) {
+        _predict_rate     = rate;
+        _ready_period_q8  = nominal_period(rate) << 8;
+        _ready_edge_valid = false;
+        _not_ready_valid  = false;
+    }
+    if (!ready) {
+        _not_ready_usec  = now;
+        _not_ready_valid = true;
+        return;
+    }
+    uint32_t period = _ready_period_q8 >> 8;
+    // The edge lies after the last not-ready read, if that was within this
+    // period, and before now.
+    bool bounded     = _not_ready_valid && (now - _not_ready_usec < period);
+    _not_ready_valid = false;
+    if (!_ready_edge_valid) {
+        _ready_edge_valid = true;
+        _ready_edge_usec  = now;
+        if (bounded) _ready_edge_usec -= (now - _not_ready_usec) >> 1;
+        return;
     }
-    return result && (_latest_raw.temperature_reg.lowest_raw <
-                      _latest_raw.temperature_reg.highest_raw);
+
+    uint32_t elapsed = now - _ready_edge_usec;
+    if (elapsed < (period >> 1)) return;  // same subpage seen again.
+    uint32_t n         = (elapsed + (period >> 1)) / period;
+    uint32_t predicted = _ready_edge_usec +
+                         (uint32_t)(((uint64_t)_ready_period_q8 * n) >> 8);
+
+    int32_t error = 0;
+    if ((int32_t)(predicted - now) > 0) {
+        error = now - predicted;  // earlier than predicted.
+    } else if (bounded && (int32_t)(_not_ready_usec - predicted) >= 0) {
+        error = _not_ready_usec - predicted + 1;  // later than predicted.
+    }
+    _ready_edge_usec = predicted + error;
+
+    // The period follows the error spread over the periods it built up in,
+    // within 1/8 of the nominal period. (unit clock tolerance)
+    int32_t nominal_q8 = nominal_period(rate) << 8;
+    int32_t period_q8  = _ready_period_q8 + (error * 256 / (int32_t)(n << 3));
+    int32_t limit      = nominal_q8 >> 3;
+    if (period_q8 < nominal_q8 - limit) period_q8 = nominal_q8 - limit;
+    if (period_q8 > nominal_q8 + limit) period_q8 = nominal_q8 + limit;
+    _ready_period_q8 = period_q8;
+}
+
+uint32_t M5_Thermal2::getFramePeriodMicros(void) const {
+    return (_predict_rate == (_written_config.refresh_rate & 7))
+               ? _ready_period_q8 >> 8
+               : nominal_period(_written_config.refresh_rate);
+}
+
+uint32_t M5_Thermal2::nextFrameDueMicros(void) const {
+    if (!_ready_edge_valid ||
+        _predict_rate != (_written_config.refresh_rate & 7)) {
+        return micros();
+    }
+    return _ready_edge_usec + (_ready_period_q8 >> 8);
+}
+
+void M5_Thermal2::waitForFrame(void) {
+    uint32_t now      = micros();
+    uint32_t interval = getPollIntervalMicros();
+    uint32_t wake     = nextFrameDueMicros() - interval;
+    if (_not_ready_valid && (int32_t)(_not_ready_usec + interval - wake) > 0) {
+        // Already past the prediction: poll at the interval.
+        wake = _not_ready_usec + interval;
+    }
+    int32_t wait = wake - now;
+    if (wait <= 0) return;
+    if (wait >= 1000) delay(wait / 1000);
+    delayMicroseconds(wait % 1000);
+}
+
+M5_Thermal2::update_state_t M5_Thermal2::_restartPixels(void) {
+    if (_restart_left == 0) return _dropChunks(failure_short_read);
+    --_restart_left;
+    ++_pixel_restarts;
+    _update_phase = phase_pixel_restart;
+    return update_busy;
+}
+
+M5_Thermal2::update_state_t M5_Thermal2::_dropChunks(failure_t failure) {
+    for (uint8_t bits = _failed_chunks; bits; bits &= bits - 1) {
+        ++_chunk_dropped;
+    }
+    _failed_chunks = 0;
+    return _fail(failure);
 }
 
 bool M5_Thermal2::buzzerOn(void) {
@@ -194,15 +616,7 @@ bool M5_Thermal2::setAlarmHighTemp(float temp_threshold,
     _highest_alarm.led.g           = led_g;
     _highest_alarm.led.b           = led_b;
 
-    if (!_checkInit()) return false;
-
-    i2c_clock_changer i2cc = {_wire, _freq};
-
-    _wire->beginTransmission(_addr);
-    _wire->write(reg_index_highest_alarm);
-    _wire->write((uint8_t*)&_highest_alarm, sizeof(_highest_alarm));
-    _init_step = (0 == _wire->endTransmission()) ? 2 : 1;
-    return (_init_step > 1);
+    return _updateConfig();
 }
 
 bool M5_Thermal2::setAlarmLowTemp(float temp_threshold,
@@ -216,15 +630,7 @@ bool M5_Thermal2::setAlarmLowTemp(float temp_threshold,
     _lowest_alarm.led.g           = led_g;
     _lowest_alarm.led.b           = led_b;
 
-    if (!_checkInit()) return false;
-
-    i2c_clock_changer i2cc = {_wire, _freq};
-
-    _wire->beginTransmission(_addr);
-    _wire->write(reg_index_lowest_alarm);
-    _wire->write((uint8_t*)&_lowest_alarm, sizeof(_lowest_alarm));
-    _init_step = (0 == _wire->endTransmission()) ? 2 : 1;
-    return (_init_step > 1);
+    return _updateConfig();
 }
 
 bool M5_Thermal2::alarmOn(alarm_bitmask_t alarm_bitmask) {
@@ -23,9 +23,14 @@ class M5_Thermal2 {
     static constexpr uint8_t reg_index_highest_alarm   = 0x30;
     static constexpr uint8_t reg_index_refresh_control = 0x6E;
     static constexpr uint8_t reg_index_overview        = 0x70;
+    static constexpr uint8_t reg_index_pixel           = 0x80;
     static constexpr uint8_t reg_device_id_0           = 0x90;
     static constexpr uint8_t reg_device_id_1           = 0x64;
 
+    static constexpr uint8_t frame_width     = 32;
+    static constexpr uint8_t frame_height    = 24;
+    static constexpr uint16_t subpage_pixels = 384;
+
     static inline float convertRawToCelsius(uint16_t rawdata) {
         return ((float)rawdata / 128) - 64.0f;
     }
@@ -80,6 +85,35 @@ class M5_Thermal2 {
         button_was_hold     = 1 << 4,
     };
 
+    // state of non-blocking update.
+    enum update_state_t : uint8_t {
+        update_idle,    // No update in progress.
+        update_busy,    // In progress. Call poll() again.
+        update_done,    // New temperature data was obtained.
+        update_failed,  // Failed, or no new temperature data.
+    };
+
+    // why an update failed.
+    enum failure_t : uint8_t {
+        failure_init,             // Unit not found / not initialized.
+        failure_not_ready,        // No new subpage. (0x6E bit 0 clear)
+        failure_nack,             // endTransmission failed.
+        failure_short_read,       // requestFrom returned fewer bytes.
+        failure_sanity,           // Overview lowest_raw >= highest_raw.
+        failure_subpage_changed,  // New subpage during a chunk retry.
+        failure_busy,             // update() while isUpdating().
+        failure_max,
+    };
+
+    // what update() reads from the unit.
+    enum acquisition_profile_t : uint8_t {
+        // status (button), refresh control, overview and pixels.
+        profile_full,
+        // refresh control and pixels only. The button state and
+        // temperature_reg (overview) are not updated.
+        profile_pixels_only,
+    };
+
     struct temperature_data_t;
 
     /*! @brief Initialize the Unit Thermal2.
@@ -112,12 +146,219 @@ class M5_Thermal2 {
                     presence of other devices. */
     void setI2CFreq(uint32_t freq, uint32_t freq_pixelread = 0);
 
+    /*! @brief Get the bus given to begin(). */
+    inline TwoWire* getWire(void) const {
+        return _wire;
+    }
+
+    /*! @brief Get the I2C communication frequency. */
+    inline uint32_t getI2CFreq(void) const {
+        return _freq;
+    }
+    /*! @brief Get the I2C communication frequency for read pixel. */
+    inline uint32_t getI2CFreqPixelRead(void) const {
+        return _freq_pixelread;
+    }
+    /*! @brief Time spent in the pixel reads of the last frame, retries
+               included. (usec) */
+    inline uint32_t getPixelReadMicros(void) const {
+        return _pixel_read_usec;
+    }
+
     /*! @brief Update temperature data and button state.
-        @return true:success / false:failure */
+        @return true:success / false:failure (failure_busy while
+                isUpdating(): finish that update with poll() first) */
     bool update(void);
 
-    /*! @brief Get temperature data from the last update.
+    /*! @brief Update temperature data into a caller-owned buffer.
+        @brief Pixel data is read straight into dst without intermediate
+               copies. getTemperatureData() is not changed by this call.
+        @param dst Destination. (e.g. a ring slot or a DMA-capable buffer)
+                   On failure its contents are undefined.
         @return true:success / false:failure */
+    bool update(temperature_data_t& dst);
+
+    /*! @brief Start a non-blocking update.
+        @brief Call poll() until it returns other than update_busy.
+               Other devices on the bus may be accessed between the calls.
+               Reads into getTemperatureData() in place, or into the
+               staging buffer set by setStagingBuffer().
+        @return true:started / false:an update is already in progress */
+    bool beginUpdate(void);
+
+    /*! @brief Start a non-blocking update into a caller-owned buffer.
+        @param dst Destination. Must stay valid until poll() returns
+                   update_done or update_failed. Written in place: while
+                   isUpdating(), it holds a mix of the new and old data.
+        @return true:started / false:an update is already in progress */
+    bool beginUpdate(temperature_data_t& dst);
+
+    /*! @brief Buffer for beginUpdate(void), so getTemperatureData() stays
+               whole while isUpdating() and changes only when poll()
+               returns update_done. (one copy of the rows read)
+        @param buffer Must stay valid while set. nullptr (default): read in
+                      place, without the extra buffer.
+        @return true:success / false:an update is in progress */
+    bool setStagingBuffer(temperature_data_t* buffer);
+
+    /*! @brief Advance a non-blocking update by at most one bus transaction.
+        @return update_busy   : in progress, call poll() again.
+                update_done   : same result as update() returning true.
+                update_failed : same result as update() returning false.
+                update_idle   : beginUpdate() has not been called. */
+    update_state_t poll(void);
+
+    /*! @brief Whether a non-blocking update is in progress.
+        @return true: in progress */
+    inline bool isUpdating(void) const {
+        return _update_phase != phase_idle;
+    }
+
+    /*! @brief Why the last update failed. (valid after update() returned
+               false or poll() returned update_failed) */
+    inline failure_t getLastFailure(void) const {
+        return _last_failure;
+    }
+
+    /*! @brief Predicted micros() at which the unit has its next subpage.
+        @brief Learned from the ready flag (0x6E) seen by update() / poll(),
+               starting from the configured refresh rate. The current micros()
+               until the first subpage has been seen. */
+    uint32_t nextFrameDueMicros(void) const;
+
+    /*! @brief Subpage period learned from the unit. (usec) */
+    uint32_t getFramePeriodMicros(void) const;
+
+    /*! @brief How early waitForFrame() wakes before the due time, and how
+               long it waits between reads that found no subpage. (usec) */
+    inline uint32_t getPollIntervalMicros(void) const {
+        return (getFramePeriodMicros() >> 6) + 500;
+    }
+
+    /*! @brief Sleep until just before the next subpage is due.
+        @brief Call update() afterwards. If that found no new subpage yet,
+               the next call sleeps a short poll interval. The bus is free
+               for other devices meanwhile. Button changes are seen by the
+               next update(). */
+    void waitForFrame(void);
+
+    /*! @brief Select what update() reads from the unit.
+        @param profile profile_full (default) / profile_pixels_only
+               profile_pixels_only skips the status and overview reads and
+               seeks straight to the pixel stream, saving 3 transactions per
+               frame (2 per not-ready poll). For headless use that needs
+               neither the button nor the device-computed overview. */
+    inline void setAcquisitionProfile(acquisition_profile_t profile) {
+        _profile = profile;
+    }
+    inline acquisition_profile_t getAcquisitionProfile(void) const {
+        return _profile;
+    }
+
+    /*! @brief Number of bus transactions saved by profile_pixels_only so
+               far, compared to profile_full. */
+    inline uint32_t getSavedTransactions(void) const {
+        return _saved_transactions;
+    }
+
+    /*! @brief Read only the first rows of each subpage.
+        @param rows 1~24 (default 24: the whole subpage)
+        @brief Each row of a subpage is 32 bytes of the pixel stream. The
+               stream can only be addressed from its start (0x80), so a band
+               of rows a~b is read with rows = b + 1. The rows from `rows` on
+               are not read: they keep the previous content of the buffer
+               and are flagged in temperature_data_t::stale_rows.
+               The unit clears its ready flag by itself only when the whole
+               stream was read, so a partial read ends with the 0x6E write
+               (one 2 byte transaction) even with auto-clear enabled.
+               While isUpdating(), the change applies from the next update. */
+    void setPixelRows(uint8_t rows);
+    inline uint8_t getPixelRows(void) const {
+        return _pixel_rows;
+    }
+
+    /*! @brief Number of pixel bytes not read because of setPixelRows() so
+               far. */
+    inline uint32_t getSavedPixelBytes(void) const {
+        return _saved_pixel_bytes;
+    }
+
+    /*! @brief Set the number of pixel read restarts allowed per frame.
+        @param restarts 0 (default) gives up the frame on the first failed
+                        chunk, as update() always did.
+        @brief After a failed chunk, the unit is checked to still hold the
+               same subpage and the pixel read starts over. The pixel stream
+               can only be addressed from its start (0x80), so every chunk
+               is read again, which takes longer than one chunk. If the
+               subpage number changed, the frame is dropped.
+               Limitation: only the parity of the subpage is seen, so if the
+               unit produced two (or any even number of) subpages since the
+               overview read, the check passes: the pixels are then those of
+               the newer subpage, and the overview is of the older one. */
+    inline void setPixelRestart(uint8_t restarts) {
+        _pixel_restart = restarts;
+    }
+    inline uint8_t getPixelRestart(void) const {
+        return _pixel_restart;
+    }
+
+    /*! @brief Number of pixel read restarts performed. */
+    inline uint32_t getPixelRestartCount(void) const {
+        return _pixel_restarts;
+    }
+    /*! @brief Number of failed pixel chunks that were read after a
+               restart. */
+    inline uint32_t getChunkRecoveredCount(void) const {
+        return _chunk_recovered;
+    }
+    /*! @brief Number of failed pixel chunks given up. (no restart left, or
+               subpage changed) */
+    inline uint32_t getChunkDroppedCount(void) const {
+        return _chunk_dropped;
+    }
+
+#if defined(M5_THERMAL2_ENABLE_STATS)
+    // Timing of one update phase. (usec)
+    struct phase_timing_t {
+        uint32_t last_usec;
+        uint32_t max_usec;
+        uint64_t total_usec;
+        uint32_t count;
+        inline uint32_t getAverageMicros(void) const {
+            return count ? total_usec / count : 0;
+        }
+    };
+
+    // Instrumentation of update() / poll().
+    // ※ M5_THERMAL2_ENABLE_STATS changes the class layout. Define it for the
+    //   whole build (e.g. build_flags = -DM5_THERMAL2_ENABLE_STATS), not
+    //   only in the sketch.
+    struct update_stats_t {
+        phase_timing_t status;           // status read and button clear.
+        phase_timing_t refresh_control;  // 0x6E ready poll.
+        phase_timing_t overview;
+        phase_timing_t pixel_chunk[6];   // each 128 byte chunk.
+        phase_timing_t pixel_restart;    // 0x6E check before a restart.
+        phase_timing_t ack;              // 0x6E write.
+        uint32_t frame_seq;              // frames obtained.
+        uint32_t subpage_seq[2];         // frames obtained per subpage.
+        uint32_t missed_subpages;        // subpages never obtained.
+        uint32_t failures[failure_max];  // failed updates per failure_t.
+        uint32_t last_frame_usec;        // micros() of the last frame.
+        uint8_t last_subpage;
+    };
+
+    /*! @brief Get the instrumentation of update() / poll(). */
+    inline const update_stats_t& getStats(void) const {
+        return _stats;
+    }
+    void resetStats(void);
+#endif
+
+    /*! @brief Get temperature data from the last update.
+        @brief update() and beginUpdate() read in place: while isUpdating()
+               or after a failure, the pixels may be partly new. With
+               setStagingBuffer(), beginUpdate() keeps it whole instead. */
     inline const temperature_data_t& getTemperatureData(void) {
         return _latest_raw;
     }
@@ -282,6 +523,20 @@ class M5_Thermal2 {
        address. */
     bool changeI2CAddr(uint8_t new_i2c_addr);
 
+    /*! @brief Start a batch of configuration changes.
+        @brief Until commit(), setters (setLed, setBuzzer, alarmOn,
+               setRefreshRate, setAlarmHighTemp ...) only update the shadow
+               registers and return true. Batches may be nested.
+        @attention update() uses the unit's current configuration until the
+                   batch is committed. */
+    void beginConfig(void);
+
+    /*! @brief Finish a batch of configuration changes.
+        @brief Only the fields that differ from what the unit holds are
+               written, whole, as one write per changed range.
+        @return true:success / false:failure */
+    bool commit(void);
+
 #pragma pack(push)
 #pragma pack(1)
 
@@ -361,9 +616,18 @@ class M5_Thermal2 {
             return temperature_reg.most_diff_y;
         }
 
+        /*! @brief Whether row y (0~23) was left unread. (see setPixelRows)
+                   A stale row keeps what the buffer held before.
+                   false for y out of range. */
+        inline bool isRowStale(uint_fast8_t y) const {
+            return (y < frame_height) && ((stale_rows >> y) & 1);
+        }
+
         temperature_reg_t temperature_reg;
         uint16_t pixel_raw[384];
         bool subpage;
+        // Bit per row (y) not read by the last update. 0: all rows read.
+        uint32_t stale_rows;
     };
 
     struct rgb_t {
@@ -429,21 +693,118 @@ class M5_Thermal2 {
 
 #pragma pack(pop)
 
+    // Full 32x24 frame assembled from both subpages.
+    // (see M5_Thermal2_FrameAssembler)
+    struct frame_data_t {
+        inline uint16_t getPixelRaw(uint_fast8_t x, uint_fast8_t y) const {
+            return (x < frame_width && y < frame_height)
+                       ? pixel_raw[x + y * frame_width]
+                       : 0;
+        }
+        inline float getPixelTemperature(uint_fast8_t x,
+                                         uint_fast8_t y) const {
+            return convertRawToCelsius(getPixelRaw(x, y));
+        }
+
+        // Overview of the subpage merged last.
+        temperature_reg_t temperature_reg;
+        // Row major. index = x + y * frame_width
+        uint16_t pixel_raw[frame_width * frame_height];
+        // Subpage merged last.
+        bool subpage;
+    };
+
    private:
+    enum update_phase_t : uint8_t {
+        phase_idle,
+        phase_init,
+        phase_status,
+        phase_button_clear,
+        phase_refresh_control,
+        phase_overview,
+        phase_pixel,
+        phase_pixel_restart,
+        phase_ack,
+    };
+
     TwoWire* _wire           = nullptr;
     uint32_t _freq           = 400000;
     uint32_t _freq_pixelread = 400000;
     uint16_t _addr           = i2c_default_addr;
     uint8_t _init_step       = 0;
 
+    update_phase_t _update_phase    = phase_idle;
+    uint8_t _pixel_chunk            = 0;
+    bool _pending_subpage           = false;
+    bool _pixel_seek                = false;
+    acquisition_profile_t _profile  = profile_full;
+    uint32_t _saved_transactions    = 0;
+    uint32_t _saved_pixel_bytes     = 0;
+    uint8_t _pixel_rows             = frame_height;
+    uint8_t _update_rows            = frame_height;  // by beginUpdate().
+    uint8_t _pixel_restart          = 0;
+    uint8_t _restart_left           = 0;
+    uint8_t _failed_chunks          = 0;  // bit per chunk awaiting a restart.
+    uint32_t _pixel_restarts        = 0;
+    uint32_t _chunk_recovered       = 0;
+    uint32_t _chunk_dropped         = 0;
+    uint32_t _pixel_read_accum      = 0;
+    uint32_t _pixel_read_usec       = 0;
+    failure_t _last_failure         = failure_init;
+    uint32_t _ready_edge_usec       = 0;  // estimated last ready edge.
+    uint32_t _ready_period_q8       = 0;  // learned subpage period, usec<<8
+    uint32_t _not_ready_usec        = 0;  // last 0x6E read without a subpage.
+    uint8_t _predict_rate           = 0xFF;  // refresh rate of the period.
+    bool _ready_edge_valid          = false;
+    bool _not_ready_valid           = false;
+    temperature_data_t* _update_dst = nullptr;
+    temperature_data_t* _staging    = nullptr;  // beginUpdate() target.
+    uint8_t _config_batch_depth     = 0;
+#if defined(M5_THERMAL2_ENABLE_STATS)
+    update_stats_t _stats = {};
+#endif
+
     temperature_data_t _latest_raw;
     status_reg_t _status;
     config_reg_t _config;
     alarm_reg_t _lowest_alarm;
     alarm_reg_t _highest_alarm;
 
+    // Register values the unit holds. (last read or successfully written)
+    config_reg_t _written_config;
+    alarm_reg_t _written_lowest_alarm;
+    alarm_reg_t _written_highest_alarm;
+
     bool _checkInit(void);
     bool _updateConfig(void);
+    bool _writeDirty(uint8_t reg_index, const void* shadow, void* written,
+                     size_t len, uint32_t field_starts);
+    update_state_t _runPhase(void);
+#if defined(M5_THERMAL2_ENABLE_STATS)
+    update_state_t _updateStep(void);
+#else
+    inline update_state_t _updateStep(void) {
+        return _runPhase();
+    }
+#endif
+    inline update_state_t _fail(failure_t failure) {
+#if defined(M5_THERMAL2_ENABLE_STATS)
+        ++_stats.failures[failure];
+#endif
+        _last_failure = failure;
+        return update_failed;
+    }
+    inline update_phase_t _firstPhase(void) const {
+        return (_profile == profile_full) ? phase_status
+                                          : phase_refresh_control;
+    }
+    void _observeReady(bool ready);
+    void _publish(void);
+    update_state_t _restartPixels(void);
+    update_state_t _dropChunks(failure_t failure);
+    inline uint32_t _phaseFreq(void) const {
+        return (_update_phase == phase_pixel) ? _freq_pixelread : _freq;
+    }
 };
 
 #endif
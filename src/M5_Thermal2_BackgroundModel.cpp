@@ -0,0 +1,151 @@
+#include "M5_Thermal2_BackgroundModel.h"
+
+#include <math.h>
+
+// Largest distance used for the variance, so its square fits.
+static constexpr int32_t distance_max = 4095;
+
+// Distance of a sample (raw << 8) from a mean, in raw, clamped.
+static inline int32_t distance_of(int32_t d) {
+    int32_t ad = ((d < 0) ? -d : d) >> 8;
+    return (ad > distance_max) ? distance_max : ad;
+}
+
+// Foreground test: beyond min_raw and beyond sigma_x4 / 4 sigma. (k2 is
+// sigma_x4 squared)
+static inline bool is_foreground(int32_t ad, uint32_t variance, uint32_t k2,
+                                 int32_t min_raw) {
+    return ad > min_raw && (uint64_t)(ad * ad) * 16 > (uint64_t)variance * k2;
+}
+
+M5_Thermal2_BackgroundModel::M5_Thermal2_BackgroundModel(void) {
+    reset();
+}
+
+void M5_Thermal2_BackgroundModel::reset(void) {
+    memset(_mean, 0, sizeof(_mean));
+    memset(_variance, 0, sizeof(_variance));
+    memset(_mask, 0, sizeof(_mask));
+    _seeded[0]        = 0;
+    _seeded[1]        = 0;
+    _foreground_count = 0;
+    _motion_score     = 0;
+    _skip_count       = 0;
+    _skipped          = 0;
+    _learnt[0]        = 0;
+    _learnt[1]        = 0;
+    _warmup[0]        = 0;
+    _warmup[1]        = 0;
+}
+
+void M5_Thermal2_BackgroundModel::setLearningRate(uint8_t rate_shift,
+                                                  uint8_t foreground_shift) {
+    if (rate_shift < 1) rate_shift = 1;
+    if (rate_shift > 15) rate_shift = 15;
+    if (foreground_shift < rate_shift) foreground_shift = rate_shift;
+    if (foreground_shift > 20) foreground_shift = 20;
+    _rate_shift       = rate_shift;
+    _foreground_shift = foreground_shift;
+}
+
+void M5_Thermal2_BackgroundModel::setThreshold(uint8_t sigma_x4,
+                                               uint16_t min_raw) {
+    _sigma_x4 = sigma_x4;
+    _min_raw  = min_raw;
+}
+
+void M5_Thermal2_BackgroundModel::setStaticSkip(uint16_t most_diff_raw,
+                                                uint8_t max_skip) {
+    _skip_raw = most_diff_raw;
+    _max_skip = max_skip;
+}
+
+float M5_Thermal2_BackgroundModel::getSigmaRaw(uint_fast8_t x,
+                                               uint_fast8_t y) const {
+    return sqrtf((float)_variance[x + y * width]);
+}
+
+bool M5_Thermal2_BackgroundModel::_nearMostDiffChanged(
+    const temperature_data_t& data) const {
+    const uint_fast8_t sp = data.subpage;
+    const uint32_t k2     = (uint32_t)_sigma_x4 * _sigma_x4;
+    const int_fast8_t cx  = data.temperature_reg.most_diff_x;
+    const int_fast8_t cy  = data.temperature_reg.most_diff_y;
+    for (int_fast8_t y = cy - 1; y <= cy + 1; ++y) {
+        if (y < 0 || y >= height) continue;
+        if ((data.stale_rows >> y) & 1) continue;
+        if (!((_seeded[sp] >> y) & 1)) continue;
+        for (int_fast8_t x = cx - 1; x <= cx + 1; ++x) {
+            // Only the pixels of this subpage. ((x + y) & 1 == subpage)
+            if (x < 0 || x >= width || ((x + y) & 1) != sp) continue;
+            const uint_fast16_t p = x + y * width;
+            const uint_fast16_t k = y * (width / 2) + (x >> 1);
+            const int32_t v       = (int32_t)data.pixel_raw[k] << 8;
+            const bool fg = is_foreground(distance_of(v - (int32_t)_mean[p]),
+                                          _variance[p], k2, _min_raw);
+            if (fg != ((_mask[y] >> x) & 1)) return true;
+        }
+    }
+    return false;
+}
+
+bool M5_Thermal2_BackgroundModel::update(const temperature_data_t& data) {
+    if (_skip_raw && isReady() && _skipped < _max_skip &&
+        data.temperature_reg.most_diff_raw < _skip_raw &&
+        !_nearMostDiffChanged(data)) {
+        ++_skipped;
+        ++_skip_count;
+        _motion_score = 0;
+        return false;
+    }
+    _skipped = 0;
+
+    const uint_fast8_t sp = data.subpage;
+    const uint8_t learnt  = _learnt[sp];
+    const bool warm       = learnt >= _rate_shift;
+    const uint32_t k2     = (uint32_t)_sigma_x4 * _sigma_x4;
+    const int32_t min_raw = _min_raw;
+    uint16_t motion       = 0;
+    int16_t count         = _foreground_count;
+
+    for (uint_fast8_t y = 0; y < height; ++y) {
+        if ((data.stale_rows >> y) & 1) continue;
+        const uint16_t* src = &data.pixel_raw[y * (width / 2)];
+        uint_fast8_t x      = (y & 1) != sp;
+        uint32_t row        = _mask[y];
+        const bool seed     = !((_seeded[sp] >> y) & 1);
+        _seeded[sp] |= 1u << y;
+        for (uint_fast8_t k = 0; k < width / 2; ++k, x += 2) {
+            const uint_fast16_t p = x + y * width;
+            const int32_t v       = (int32_t)src[k] << 8;
+            if (seed) {
+                // First time the row is read: the pixel is the background.
+                _mean[p]     = v;
+                _variance[p] = min_raw * min_raw;
+                continue;
+            }
+            int32_t d   = v - (int32_t)_mean[p];
+            int32_t ad  = distance_of(d);
+            uint32_t d2 = ad * ad;
+
+            bool fg = warm && is_foreground(ad, _variance[p], k2, min_raw);
+            uint8_t shift = !warm ? learnt
+                            : fg  ? _foreground_shift
+                                  : _rate_shift;
+            _mean[p] += d >> shift;
+            _variance[p] += ((int32_t)d2 - (int32_t)_variance[p]) >> shift;
+
+            if (fg != ((row >> x) & 1)) {
+                row ^= 1u << x;
+                count += fg ? 1 : -1;
+                ++motion;
+            }
+        }
+        _mask[y] = row;
+    }
+
+    if (!warm && ++_warmup[sp] >= (1u << learnt)) _learnt[sp] = learnt + 1;
+    _foreground_count = count;
+    _motion_score     = motion;
+    return true;
+}
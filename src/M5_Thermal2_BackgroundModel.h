@@ -0,0 +1,121 @@
+/*!
+ * @brief Per-pixel background model for presence and motion detection.
+ * @copyright Copyright (c) 2022 by M5Stack[https://m5stack.com]
+ *
+ * Each pixel keeps a running mean (raw << 8) and variance (raw^2) of its
+ * background, updated from the subpage that covers it. A pixel is foreground
+ * when it differs from its mean by more than threshold sigma and by more
+ * than min_raw. Background pixels learn at 1/2^rate_shift per subpage of
+ * their parity, foreground pixels at the slower 1/2^foreground_shift, so a
+ * person standing still is absorbed only after a while; after reset() the
+ * rate starts at 1/1, 1/2, 1/4 ... so the model is usable within a few
+ * subpages.
+ *
+ * Output per subpage: a foreground bitmask of the frame (one uint32_t per
+ * row, bit x), the number of foreground pixels (presence) and the motion
+ * score: pixels of the subpage that entered or left the foreground (motion).
+ * Every update() visits 384 pixels at most, nothing is allocated. With the
+ * static skip enabled, a subpage whose overview most_diff_raw (the unit's
+ * largest pixel change inside its monitor area) is below a threshold is not
+ * visited at all: the mask is kept and the motion score is 0. Before
+ * skipping, the pixels of the subpage next to most_diff_x/y are tested
+ * against the background, so a slow change there, each step below the
+ * threshold, is not skipped once it reaches the foreground test. Changes
+ * elsewhere are seen after max_skip subpages at the latest. Rows
+ * left unread (stale_rows) are not learnt; a row is seeded from the first
+ * subpage that reads it.
+ */
+#ifndef _M5_THERMAL2_BACKGROUNDMODEL_H_
+#define _M5_THERMAL2_BACKGROUNDMODEL_H_
+
+#include "M5_Thermal2.h"
+
+class M5_Thermal2_BackgroundModel {
+   public:
+    typedef M5_Thermal2::temperature_data_t temperature_data_t;
+
+    M5_Thermal2_BackgroundModel(void);
+
+    /*! @brief Set the learning rates, in subpages of a parity.
+        @param rate_shift background pixels, 1 ~ 15 (default 7: 128)
+        @param foreground_shift foreground pixels, rate_shift ~ 20
+                                (default 12: 4096, about 2 min at 32 Hz) */
+    void setLearningRate(uint8_t rate_shift = 7, uint8_t foreground_shift = 12);
+
+    /*! @brief Set the foreground test.
+        @param sigma_x4 distance from the mean, in sigma x 4 (default 12: 3)
+        @param min_raw smallest distance, whatever the variance (default 32) */
+    void setThreshold(uint8_t sigma_x4 = 12, uint16_t min_raw = 32);
+
+    /*! @brief Skip subpages the unit reports as static.
+        @param most_diff_raw threshold of temperature_reg.most_diff_raw,
+                             0:disabled (default). Needs profile_full.
+        @param max_skip consecutive subpages skipped at most, so the model
+                        still follows slow changes. (default 16) */
+    void setStaticSkip(uint16_t most_diff_raw, uint8_t max_skip = 16);
+
+    /*! @brief Test and learn a subpage.
+        @return true:processed / false:skipped as static */
+    bool update(const temperature_data_t& data);
+
+    /*! @brief Foreground mask of the frame: row y, bit x. */
+    inline const uint32_t* getForegroundMask(void) const {
+        return _mask;
+    }
+    inline bool isForeground(uint_fast8_t x, uint_fast8_t y) const {
+        return (x < width && y < height) && ((_mask[y] >> x) & 1);
+    }
+    /*! @brief Foreground pixels of the frame. (presence) */
+    inline uint16_t getForegroundCount(void) const {
+        return _foreground_count;
+    }
+    /*! @brief Pixels of the last subpage that entered or left the
+               foreground. 0 when it was skipped. (motion) */
+    inline uint16_t getMotionScore(void) const {
+        return _motion_score;
+    }
+    /*! @brief Subpages skipped as static since reset(). */
+    inline uint32_t getSkipCount(void) const {
+        return _skip_count;
+    }
+
+    /*! @brief Background of a pixel. (raw) */
+    inline uint16_t getBackgroundRaw(uint_fast8_t x, uint_fast8_t y) const {
+        return (_mean[x + y * width] + 128) >> 8;
+    }
+    /*! @brief Standard deviation of a pixel's background. (raw) */
+    float getSigmaRaw(uint_fast8_t x, uint_fast8_t y) const;
+
+    /*! @brief Whether both subpages have been learnt for 1/2^rate_shift. */
+    inline bool isReady(void) const {
+        return _learnt[0] >= _rate_shift && _learnt[1] >= _rate_shift;
+    }
+
+    /*! @brief Forget the background. */
+    void reset(void);
+
+   private:
+    static constexpr uint8_t width  = M5_Thermal2::frame_width;
+    static constexpr uint8_t height = M5_Thermal2::frame_height;
+
+    bool _nearMostDiffChanged(const temperature_data_t& data) const;
+
+    uint32_t _mean[width * height];  // raw << 8
+    uint32_t _variance[width * height];
+    uint32_t _mask[height];
+    uint32_t _seeded[2];  // rows read per subpage since reset().
+    uint32_t _skip_count       = 0;
+    uint16_t _foreground_count = 0;
+    uint16_t _motion_score     = 0;
+    uint16_t _min_raw          = 32;
+    uint16_t _skip_raw         = 0;
+    uint8_t _max_skip          = 16;
+    uint8_t _skipped           = 0;  // consecutive.
+    uint8_t _sigma_x4          = 12;
+    uint8_t _rate_shift        = 7;
+    uint8_t _foreground_shift  = 12;
+    uint8_t _learnt[2]         = {0, 0};  // warm-up shift per subpage.
+    uint16_t _warmup[2]        = {0, 0};  // subpages since reset().
+};
+
+#endif
@@ -0,0 +1,237 @@
+#include "M5_Thermal2_BlobTracker.h"
+
+uint16_t M5_Thermal2_BlobTracker::_find(uint16_t label) {
+    // Path halving.
+    while (_parent[label] != label) {
+        _parent[label] = _parent[_parent[label]];
+        label          = _parent[label];
+    }
+    return label;
+}
+
+void M5_Thermal2_BlobTracker::_union(uint16_t a, uint16_t b) {
+    a = _find(a);
+    b = _find(b);
+    // The smaller label becomes the root, so a parent always precedes its
+    // children and the fold below needs one pass.
+    if (a < b) {
+        _parent[b] = a;
+    } else if (b < a) {
+        _parent[a] = b;
+    }
+}
+
+uint8_t M5_Thermal2_BlobTracker::update(const uint16_t* frame) {
+    const uint16_t threshold = _threshold;
+    uint16_t count           = 0;
+
+    // Raster pass. Of the neighbours above and to the left, N touches the
+    // three others, and W touches NW, so at most one union is needed:
+    // NE with W (or NW) when N is not hot.
+    for (uint_fast8_t y = 0; y < height; ++y) {
+        const uint16_t* __restrict src = &frame[y * width];
+        uint16_t* __restrict lab       = &_label[y * width];
+        const uint16_t* __restrict up  = lab - width;
+        for (uint_fast8_t x = 0; x < width; ++x) {
+            uint16_t v = src[x];
+            if (v < threshold) {
+                lab[x] = 0;
+                continue;
+            }
+            uint16_t w  = x ? lab[x - 1] : 0;
+            uint16_t n  = 0;
+            uint16_t nw = 0;
+            uint16_t ne = 0;
+            if (y) {
+                n  = up[x];
+                nw = x ? up[x - 1] : 0;
+                ne = (x < width - 1) ? up[x + 1] : 0;
+            }
+            uint16_t l;
+            if (n) {
+                l = n;
+            } else if (ne) {
+                l = ne;
+                if (w) {
+                    _union(ne, w);
+                } else if (nw) {
+                    _union(ne, nw);
+                }
+            } else if (w) {
+                l = w;
+            } else if (nw) {
+                l = nw;
+            } else {
+                l                     = ++count;
+                _parent[l]            = l;
+                _region[l]            = region_t{};
+                _region[l].peak_index = x + y * width;
+                _region[l].left       = x;
+                _region[l].top        = y;
+            }
+            lab[x] = l;
+
+            region_t& r     = _region[l];
+            uint32_t weight = v - threshold + 1;
+            r.weight += weight;
+            r.weight_x += weight * x;
+            r.weight_y += weight * y;
+            ++r.area;
+            if (r.peak_raw < v) {
+                r.peak_raw   = v;
+                r.peak_index = x + y * width;
+            }
+            if (r.left > x) r.left = x;
+            if (r.right < x) r.right = x;
+            r.bottom = y;
+        }
+    }
+    _label_count = count;
+    _collect();
+    _match();
+    return _blob_count;
+}
+
+void M5_Thermal2_BlobTracker::_collect(void) {
+    // Flatten: a parent precedes its children, so it is flat already.
+    for (uint_fast16_t l = 1; l <= _label_count; ++l) {
+        _parent[l] = _parent[_parent[l]];
+    }
+    // Fold the sums into the roots, children first.
+    uint16_t regions = 0;
+    for (uint_fast16_t l = _label_count; l > 0; --l) {
+        uint16_t root = _parent[l];
+        _blob_of[l]   = no_blob;
+        if (root == l) {
+            ++regions;
+            continue;
+        }
+        region_t& r = _region[root];
+        region_t& c = _region[l];
+        r.weight += c.weight;
+        r.weight_x += c.weight_x;
+        r.weight_y += c.weight_y;
+        r.area += c.area;
+        if (r.peak_raw < c.peak_raw) {
+            r.peak_raw   = c.peak_raw;
+            r.peak_index = c.peak_index;
+        }
+        if (r.left > c.left) r.left = c.left;
+        if (r.top > c.top) r.top = c.top;
+        if (r.right < c.right) r.right = c.right;
+        if (r.bottom < c.bottom) r.bottom = c.bottom;
+    }
+    _region_count = regions;
+
+    // Keep the largest blob_max roots, largest first. (insertion)
+    uint16_t order[blob_max];
+    uint8_t n = 0;
+    for (uint_fast16_t l = 1; l <= _label_count; ++l) {
+        if (_parent[l] != l || _region[l].area < _min_area) continue;
+        uint16_t area = _region[l].area;
+        if (n == blob_max && _region[order[n - 1]].area >= area) continue;
+        uint8_t i = (n < blob_max) ? n++ : n - 1;
+        for (; i && _region[order[i - 1]].area < area; --i) {
+            order[i] = order[i - 1];
+        }
+        order[i] = l;
+    }
+
+    for (uint_fast8_t i = 0; i < n; ++i) {
+        const region_t& r = _region[order[i]];
+        blob_t& b         = _blob[i];
+        b.id              = 0;
+        b.age             = 0;
+        b.area            = r.area;
+        b.peak_raw        = r.peak_raw;
+        b.peak_x          = r.peak_index % width;
+        b.peak_y          = r.peak_index / width;
+        b.centroid_x      = ((uint64_t)r.weight_x << 8) / r.weight;
+        b.centroid_y      = ((uint64_t)r.weight_y << 8) / r.weight;
+        b.left            = r.left;
+        b.top             = r.top;
+        b.right           = r.right;
+        b.bottom          = r.bottom;
+
+        _blob_of[order[i]] = i;
+    }
+    _blob_count = n;
+}
+
+void M5_Thermal2_BlobTracker::_match(void) {
+    const uint32_t limit = (uint32_t)(_max_distance << 8) *
+                           (uint32_t)(_max_distance << 8);
+    uint32_t matched_blob  = 0;  // bit per blob.
+    uint32_t matched_track = 0;  // bit per track.
+
+    // Greedy: the closest pair of unmatched blob and track first.
+    for (;;) {
+        uint32_t best = limit + 1;
+        uint8_t bi    = 0;
+        uint8_t ti    = 0;
+        for (uint_fast8_t t = 0; t < _track_count; ++t) {
+            if (matched_track & (1u << t)) continue;
+            for (uint_fast8_t b = 0; b < _blob_count; ++b) {
+                if (matched_blob & (1u << b)) continue;
+                int32_t dx = (int32_t)_blob[b].centroid_x -
+                             _track[t].centroid_x;
+                int32_t dy = (int32_t)_blob[b].centroid_y -
+                             _track[t].centroid_y;
+                uint32_t d = dx * dx + dy * dy;
+                if (d < best) {
+                    best = d;
+                    bi   = b;
+                    ti   = t;
+                }
+            }
+        }
+        if (best > limit) break;
+        matched_blob |= 1u << bi;
+        matched_track |= 1u << ti;
+        _blob[bi].id  = _track[ti].id;
+        _blob[bi].age = _track[ti].age + 1;
+    }
+
+    // Tracks not seen for too long are dropped, the rest wait.
+    uint8_t count = 0;
+    track_t keep[blob_max];
+    for (uint_fast8_t t = 0; t < _track_count; ++t) {
+        if (matched_track & (1u << t)) continue;
+        if (_track[t].missing >= _max_missing) continue;
+        keep[count] = _track[t];
+        ++keep[count].missing;
+        ++count;
+    }
+    // New tracks for the new blobs. Seen blobs come first, so a track that
+    // waits is the one given up when there are too many.
+    _track_count = 0;
+    for (uint_fast8_t b = 0; b < _blob_count; ++b) {
+        blob_t& blob = _blob[b];
+        if (!(matched_blob & (1u << b))) {
+            blob.id  = _next_id;
+            blob.age = 1;
+            if (++_next_id == 0) _next_id = 1;
+        }
+        _track[_track_count++] = {blob.id, blob.age, blob.centroid_x,
+                                  blob.centroid_y, 0};
+    }
+    for (uint_fast8_t t = 0; t < count && _track_count < blob_max; ++t) {
+        _track[_track_count++] = keep[t];
+    }
+}
+
+int M5_Thermal2_BlobTracker::getBlobIndex(uint_fast8_t x,
+                                          uint_fast8_t y) const {
+    if (x >= width || y >= height) return -1;
+    uint16_t l = _label[x + y * width];
+    if (l == 0 || l > _label_count) return -1;
+    uint8_t b = _blob_of[_parent[l]];
+    return (b == no_blob) ? -1 : b;
+}
+
+void M5_Thermal2_BlobTracker::reset(void) {
+    _track_count  = 0;
+    _blob_count   = 0;
+    _region_count = 0;
+    _label_count  = 0;  // getBlobIndex() no longer sees the old labels.
+}
@@ -0,0 +1,161 @@
+/*!
+ * @brief Hot region labelling and frame-to-frame tracking for Unit Thermal2.
+ * @copyright Copyright (c) 2022 by M5Stack[https://m5stack.com]
+ *
+ * Pixels at or above a threshold are grouped into 8-connected regions in one
+ * raster pass (union-find over provisional labels). Area, weighted centroid,
+ * peak and bounding box are summed per provisional label during the pass and
+ * folded into the region roots afterwards, so the pixels are visited once.
+ * The regions are then matched to those of the previous frame by centroid
+ * distance, and keep their id while they move.
+ *
+ * All tables are fixed size (about 12 KB in total), nothing is allocated.
+ * Worst case per frame, whatever the scene:
+ *   - raster pass : 768 pixels, at most 4 neighbour reads and 1 union each
+ *   - fold        : 384 provisional labels (a new label needs a background
+ *                   pixel on its left, so at most 16 per row)
+ *   - selection   : blob_max insertion steps per region
+ *   - tracking    : blob_max rounds over blob_max x blob_max pairs
+ * bench_blobs measures these worst cases with synthetic patterns.
+ */
+#ifndef _M5_THERMAL2_BLOBTRACKER_H_
+#define _M5_THERMAL2_BLOBTRACKER_H_
+
+#include "M5_Thermal2.h"
+
+class M5_Thermal2_BlobTracker {
+   public:
+    /// Regions reported per frame. (the largest ones)
+    static constexpr uint8_t blob_max = 16;
+
+    struct blob_t {
+        uint16_t id;          // stable across frames. (never 0)
+        uint16_t age;         // frames this id has been seen.
+        uint16_t area;        // pixels.
+        uint16_t peak_raw;    // highest raw value.
+        uint16_t centroid_x;  // weighted by (raw - threshold + 1). (x256)
+        uint16_t centroid_y;
+        uint8_t peak_x;
+        uint8_t peak_y;
+        // Bounding box, inclusive.
+        uint8_t left;
+        uint8_t top;
+        uint8_t right;
+        uint8_t bottom;
+
+        inline float getCentroidX(void) const {
+            return centroid_x / 256.0f;
+        }
+        inline float getCentroidY(void) const {
+            return centroid_y / 256.0f;
+        }
+        inline float getPeakTemperature(void) const {
+            return M5_Thermal2::convertRawToCelsius(peak_raw);
+        }
+    };
+
+    /*! @brief Set the threshold. Pixels at or above it are hot. (raw) */
+    inline void setThreshold(uint16_t raw) {
+        _threshold = raw;
+    }
+    inline void setThresholdTemperature(float celsius) {
+        _threshold = M5_Thermal2::convertCelsiusToRaw(celsius);
+    }
+    inline uint16_t getThreshold(void) const {
+        return _threshold;
+    }
+
+    /*! @brief Regions smaller than this are ignored. (pixels, default 1) */
+    inline void setMinArea(uint16_t pixels) {
+        _min_area = pixels;
+    }
+
+    /*! @brief Farthest a region may move between frames and keep its id.
+        @param pixels default 4 */
+    inline void setMaxDistance(uint8_t pixels) {
+        _max_distance = pixels;
+    }
+
+    /*! @brief Frames a region may disappear and come back with its id.
+        @param frames default 2 */
+    inline void setMaxMissing(uint8_t frames) {
+        _max_missing = frames;
+    }
+
+    /*! @brief Label and track a frame.
+        @param frame 32x24 row major raw values. (frame_data_t::pixel_raw)
+        @return number of blobs. (up to blob_max) */
+    uint8_t update(const uint16_t* frame);
+
+    /*! @brief Number of regions found by the last update(), before the
+               blob_max and min area limits. */
+    inline uint16_t getRegionCount(void) const {
+        return _region_count;
+    }
+    inline uint8_t getBlobCount(void) const {
+        return _blob_count;
+    }
+    /*! @brief Blobs of the last update(), largest first. */
+    inline const blob_t& getBlob(uint8_t index) const {
+        return _blob[index];
+    }
+
+    /*! @brief Blob index at a pixel of the last update().
+        @return index for getBlob(), or -1 (not hot, or not reported) */
+    int getBlobIndex(uint_fast8_t x, uint_fast8_t y) const;
+
+    /*! @brief Forget the tracks and the blobs of the last update(). */
+    void reset(void);
+
+   private:
+    static constexpr uint8_t width      = M5_Thermal2::frame_width;
+    static constexpr uint8_t height     = M5_Thermal2::frame_height;
+    static constexpr uint16_t label_max = (width / 2) * height;
+    static constexpr uint8_t no_blob    = 0xFF;
+
+    // Sums of one provisional label.
+    struct region_t {
+        uint32_t weight;
+        uint32_t weight_x;
+        uint32_t weight_y;
+        uint16_t area;
+        uint16_t peak_raw;
+        uint16_t peak_index;
+        uint8_t left;
+        uint8_t top;
+        uint8_t right;
+        uint8_t bottom;
+    };
+
+    // Blob of the previous frames.
+    struct track_t {
+        uint16_t id;
+        uint16_t age;
+        uint16_t centroid_x;
+        uint16_t centroid_y;
+        uint8_t missing;
+    };
+
+    uint16_t _label[width * height];  // provisional label, 0: not hot.
+    uint16_t _parent[label_max + 1];  // union-find, parent < child.
+    uint8_t _blob_of[label_max + 1];  // blob index per root.
+    region_t _region[label_max + 1];
+    blob_t _blob[blob_max];
+    track_t _track[blob_max];
+    uint16_t _threshold    = 0;
+    uint16_t _min_area     = 1;
+    uint16_t _region_count = 0;
+    uint16_t _next_id      = 1;
+    uint8_t _blob_count    = 0;
+    uint8_t _track_count   = 0;
+    uint8_t _max_distance  = 4;
+    uint8_t _max_missing   = 2;
+    uint16_t _label_count  = 0;
+
+    uint16_t _find(uint16_t label);
+    void _union(uint16_t a, uint16_t b);
+    void _collect(void);
+    void _match(void);
+};
+
+#endif
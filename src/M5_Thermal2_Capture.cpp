@@ -0,0 +1,352 @@
+#include "M5_Thermal2_Capture.h"
+
+typedef M5_Thermal2_Capture fmt;
+
+static constexpr uint8_t magic[4]     = {'M', 'T', '2', 'C'};
+static constexpr uint8_t unary_escape = 16;
+static constexpr uint8_t escape_bits  = 17;
+// Prediction of the first pixel of a key record. (0 degree Celsius)
+static constexpr uint16_t key_origin = 64 * 128;
+// Adaptive rice parameter: running residual sum and count, halved at
+// rice_reset so the parameter follows local detail.
+static constexpr uint8_t rice_init  = 4;
+static constexpr uint8_t rice_reset = 16;
+
+static inline uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+static inline int32_t unzigzag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+static size_t put_varint(uint8_t* dst, uint32_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        dst[n++] = value | 0x80;
+        value >>= 7;
+    }
+    dst[n++] = value;
+    return n;
+}
+
+struct rice_state_t {
+    uint32_t sum;
+    uint32_t count;
+
+    inline void begin(uint8_t k) {
+        count = rice_init;
+        sum   = rice_init << k;
+    }
+    inline uint8_t param(void) const {
+        uint8_t k = 0;
+        while (k < 15 && (count << k) < sum) ++k;
+        return k;
+    }
+    inline void add(uint32_t residual) {
+        sum += residual;
+        if (++count == rice_reset) {
+            sum >>= 1;
+            count >>= 1;
+        }
+    }
+};
+
+bool M5_Thermal2_CaptureEncoder::begin(Print* dst) {
+    _dst       = dst;
+    _records   = 0;
+    _bytes     = 0;
+    _prev_usec = 0;
+    _valid[0]  = false;
+    _valid[1]  = false;
+
+    uint8_t header[fmt::header_size] = {magic[0], magic[1], magic[2],
+                                        magic[3], fmt::version};
+    if (dst == nullptr ||
+        dst->write(header, sizeof(header)) != sizeof(header)) {
+        return false;
+    }
+    _bytes = sizeof(header);
+    return true;
+}
+
+// Rice code of the residuals against ref (same pixel of the previous
+// subpage) or, without ref, against the previous pixel.
+// Returns the payload size, or 0 if it would not fit into limit bytes.
+size_t M5_Thermal2_CaptureEncoder::_encodeRice(const uint16_t* pixel,
+                                               const uint16_t* ref,
+                                               uint8_t* dst, size_t limit) {
+    uint32_t residual[fmt::pixel_count];
+    uint32_t sum = 0;
+    int32_t prev = key_origin;
+    for (size_t i = 0; i < fmt::pixel_count; ++i) {
+        int32_t p   = ref ? ref[i] : prev;
+        residual[i] = zigzag((int32_t)pixel[i] - p);
+        sum += residual[i];
+        prev = pixel[i];
+    }
+    // Initial parameter: largest k with 2^k <= mean residual.
+    uint8_t k0 = 0;
+    while (k0 < 15 && ((uint32_t)fmt::pixel_count << (k0 + 1)) <= sum) ++k0;
+    rice_state_t rice;
+    rice.begin(k0);
+
+    dst[0]       = k0;
+    size_t pos   = 1;
+    uint32_t acc = 0;
+    uint8_t bits = 0;
+    auto put     = [&](uint32_t value, uint8_t n) {
+        acc |= value << bits;
+        bits += n;
+        while (bits >= 8) {
+            dst[pos++] = acc;
+            acc >>= 8;
+            bits -= 8;
+        }
+    };
+    for (size_t i = 0; i < fmt::pixel_count; ++i) {
+        // Worst case of one pixel: 16 ones and 17 bits, 5 bytes.
+        if (pos + 5 > limit) return 0;
+        uint32_t r = residual[i];
+        uint8_t k  = rice.param();
+        uint32_t q = r >> k;
+        rice.add(r);
+        if (q < unary_escape) {
+            put((1u << q) - 1, q + 1);  // q ones and a zero.
+            put(r & ((1u << k) - 1), k);
+        } else {
+            put((1u << unary_escape) - 1, unary_escape);
+            put(r, escape_bits);
+        }
+    }
+    if (bits) dst[pos++] = acc;
+    return (pos <= limit) ? pos : 0;
+}
+
+bool M5_Thermal2_CaptureEncoder::write(const temperature_data_t& src,
+                                       uint32_t usec) {
+    if (_dst == nullptr) return false;
+    const uint8_t sp = src.subpage;
+    bool key =
+        !_valid[sp] || (_key_interval && _since_key[sp] >= _key_interval);
+
+    uint8_t tag = (sp ? fmt::tag_subpage : 0) | (key ? fmt::tag_key : 0);
+    size_t pos  = put_varint(_body, _records ? usec - _prev_usec : usec);
+    if (_overview) {
+        tag |= fmt::tag_overview;
+        memcpy(&_body[pos], &src.temperature_reg, sizeof(src.temperature_reg));
+        pos += sizeof(src.temperature_reg);
+    }
+    size_t len = _encodeRice(src.pixel_raw, key ? nullptr : _prev[sp],
+                             &_body[pos], fmt::raw_size);
+    if (len) {
+        tag |= fmt::coding_rice;
+    } else {
+        // Does not compress. (noise) Raw pixels are a key as well.
+        tag |= fmt::tag_key;
+        key = true;
+        for (size_t i = 0; i < fmt::pixel_count; ++i) {
+            _body[pos + i * 2]     = src.pixel_raw[i];
+            _body[pos + i * 2 + 1] = src.pixel_raw[i] >> 8;
+        }
+        len = fmt::raw_size;
+    }
+    pos += len;
+
+    uint8_t head[6];
+    head[0]   = tag;
+    size_t hn = 1 + put_varint(&head[1], pos);
+    bool ok   = (_dst->write(head, hn) == hn) &&
+                (_dst->write(_body, pos) == pos);
+    if (!ok) {
+        // The reader loses this record, so the next ones must be keys.
+        _valid[0] = false;
+        _valid[1] = false;
+        return false;
+    }
+    memcpy(_prev[sp], src.pixel_raw, sizeof(_prev[sp]));
+    _valid[sp]     = true;
+    _since_key[sp] = key ? 1 : _since_key[sp] + 1;
+    _prev_usec     = usec;
+    _bytes += hn + pos;
+    ++_records;
+    return true;
+}
+
+bool M5_Thermal2_CaptureDecoder::begin(Stream* src) {
+    _src      = src;
+    _version  = 0;
+    _records  = 0;
+    _skipped  = 0;
+    _usec     = 0;
+    _valid[0] = false;
+    _valid[1] = false;
+    uint8_t header[fmt::header_size];
+    if (src == nullptr ||
+        src->readBytes(header, sizeof(header)) != sizeof(header) ||
+        memcmp(header, magic, sizeof(magic)) != 0 || header[4] == 0 ||
+        header[4] > fmt::version) {
+        _src = nullptr;
+        return false;
+    }
+    _version = header[4];
+    return true;
+}
+
+bool M5_Thermal2_CaptureDecoder::_readVarint(uint32_t& value) {
+    value = 0;
+    for (uint_fast8_t shift = 0; shift < 35; shift += 7) {
+        int c = _src->read();
+        if (c < 0) return false;
+        value |= (uint32_t)(c & 0x7F) << shift;
+        if (!(c & 0x80)) return true;
+    }
+    return false;
+}
+
+bool M5_Thermal2_CaptureDecoder::_decodeRice(const uint8_t* src, size_t len,
+                                             const uint16_t* ref,
+                                             uint16_t* pixel) {
+    if (len < 1 || src[0] > 15) return false;
+    rice_state_t rice;
+    rice.begin(src[0]);
+    size_t pos   = 1;
+    uint32_t acc = 0;
+    uint8_t bits = 0;
+    // Keep at least n bits in acc. Past the end, zero bits are read and
+    // caught by the length check below.
+    auto fill = [&](uint8_t n) {
+        while (bits < n) {
+            acc |= (uint32_t)((pos < len) ? src[pos] : 0) << bits;
+            ++pos;
+            bits += 8;
+        }
+    };
+    int32_t prev = key_origin;
+    for (size_t i = 0; i < fmt::pixel_count; ++i) {
+        fill(unary_escape + 1);
+        uint8_t k  = rice.param();
+        uint32_t q = 0;
+        while (q < unary_escape && (acc & 1)) {
+            acc >>= 1;
+            ++q;
+        }
+        uint32_t r;
+        if (q < unary_escape) {
+            acc >>= 1;  // the ending zero.
+            bits -= q + 1;
+            fill(k);
+            r = (q << k) | (acc & ((1u << k) - 1));
+            acc >>= k;
+            bits -= k;
+        } else {
+            bits -= unary_escape;
+            fill(escape_bits);
+            r = acc & ((1u << escape_bits) - 1);
+            acc >>= escape_bits;
+            bits -= escape_bits;
+        }
+        rice.add(r);
+        int32_t v = (ref ? ref[i] : prev) + unzigzag(r);
+        pixel[i]  = v;
+        prev      = pixel[i];
+    }
+    // Bytes consumed, without the look-ahead still held in acc.
+    return pos - (bits >> 3) <= len;
+}
+
+bool M5_Thermal2_CaptureDecoder::read(temperature_data_t& dst,
+                                      uint32_t* usec) {
+    if (_src == nullptr) return false;
+    for (;;) {
+        int tag = _src->read();
+        uint32_t body_len;
+        if (tag < 0 || !_readVarint(body_len)) return false;
+        if (body_len > sizeof(_body) ||
+            _src->readBytes(_body, body_len) != body_len) {
+            return false;
+        }
+        ++_records;
+
+        const uint8_t sp     = tag & fmt::tag_subpage;
+        const uint8_t coding = tag & fmt::tag_coding;
+        size_t pos           = 0;
+        uint32_t delta       = 0;
+        for (uint_fast8_t shift = 0; pos < body_len && shift < 35;
+             shift += 7) {
+            uint8_t c = _body[pos++];
+            delta |= (uint32_t)(c & 0x7F) << shift;
+            if (!(c & 0x80)) break;
+        }
+        // The time line continues through skipped records.
+        _usec = (_records > 1) ? _usec + delta : delta;
+
+        bool known = !(tag & ~(fmt::tag_subpage | fmt::tag_key |
+                               fmt::tag_overview | fmt::tag_coding)) &&
+                     (coding == fmt::coding_raw || coding == fmt::coding_rice);
+        if (!known || (coding != fmt::coding_raw && !(tag & fmt::tag_key) &&
+                       !_valid[sp])) {
+            ++_skipped;
+            continue;
+        }
+
+        if (tag & fmt::tag_overview) {
+            if (pos + sizeof(dst.temperature_reg) > body_len) return false;
+            memcpy(&dst.temperature_reg, &_body[pos],
+                   sizeof(dst.temperature_reg));
+            pos += sizeof(dst.temperature_reg);
+        } else {
+            memset(&dst.temperature_reg, 0, sizeof(dst.temperature_reg));
+        }
+        if (coding == fmt::coding_raw) {
+            if (pos + fmt::raw_size > body_len) return false;
+            for (size_t i = 0; i < fmt::pixel_count; ++i) {
+                dst.pixel_raw[i] = _body[pos + i * 2] |
+                                   (uint16_t)_body[pos + i * 2 + 1] << 8;
+            }
+        } else if (!_decodeRice(&_body[pos], body_len - pos,
+                                (tag & fmt::tag_key) ? nullptr : _prev[sp],
+                                dst.pixel_raw)) {
+            return false;
+        }
+        dst.subpage    = sp;
+        dst.stale_rows = 0;
+        memcpy(_prev[sp], dst.pixel_raw, sizeof(_prev[sp]));
+        _valid[sp] = true;
+        if (usec) *usec = _usec;
+        return true;
+    }
+}
+
+bool M5_Thermal2_Replay::begin(Stream* src, bool realtime) {
+    _realtime   = realtime;
+    _start_usec = micros();
+    _has_next   = _decoder.begin(src) && _decoder.read(_next, &_next_usec);
+    _first_usec = _next_usec;
+    return _decoder.getVersion() != 0;
+}
+
+uint32_t M5_Thermal2_Replay::nextFrameDueMicros(void) const {
+    return _realtime ? _start_usec + (_next_usec - _first_usec) : micros();
+}
+
+void M5_Thermal2_Replay::waitForFrame(void) {
+    int32_t wait = nextFrameDueMicros() - micros();
+    if (!_has_next || wait <= 0) return;
+    if (wait >= 1000) delay(wait / 1000);
+    delayMicroseconds(wait % 1000);
+}
+
+bool M5_Thermal2_Replay::update(void) {
+    return update(_latest);
+}
+
+bool M5_Thermal2_Replay::update(temperature_data_t& dst) {
+    if (!_has_next) return false;
+    if (_realtime && (int32_t)(micros() - nextFrameDueMicros()) < 0) {
+        return false;
+    }
+    dst          = _next;
+    _latest_usec = _next_usec;
+    _has_next    = _decoder.read(_next, &_next_usec);
+    return true;
+}
@@ -0,0 +1,199 @@
+/*!
+ * @brief Compact capture stream of Unit Thermal2 subpages, and its replay.
+ * @copyright Copyright (c) 2022 by M5Stack[https://m5stack.com]
+ *
+ * Stream layout (version 1, multi-byte fields little endian):
+ *
+ *   header : 'M' 'T' '2' 'C' version(1) reserved(3)
+ *   record : tag(1) body_length(varint) body
+ *   body   : time_delta(varint, usec since the previous record)
+ *            [temperature_reg_t (16), if tag_overview]
+ *            payload
+ *
+ *   tag bit 0   : subpage
+ *       bit 1   : key record. Pixels are predicted from the previous pixel
+ *                 of the same subpage instead of the previous subpage of the
+ *                 same parity.
+ *       bit 2   : overview present
+ *       bit 3~4 : coding. 0: raw, 384 x uint16. 1: rice, see below.
+ *       bit 5~7 : 0. Records with other values are skipped.
+ *
+ *   rice payload : k0(1), then per pixel the zigzag prediction residual r
+ *                  as (r >> k) in unary (ones, ended by a zero) and the low
+ *                  k bits. A unary run of 16 ones is followed by r in 17
+ *                  bits instead. Bits are packed LSB first, the payload is
+ *                  padded to a byte.
+ *                  k adapts per pixel: the smallest k (up to 15) with
+ *                  (N << k) >= A, A being the sum of the earlier residuals
+ *                  and N their count. A and N start as (4 << k0) and 4, and
+ *                  both are halved when N reaches 16.
+ *
+ * Static scenes cost a few bits per pixel, since each pixel is predicted from
+ * the same pixel one frame (two subpages) earlier. Records are
+ * self-delimiting and start with key records, so a reader may start at any
+ * key record of each subpage.
+ */
+#ifndef _M5_THERMAL2_CAPTURE_H_
+#define _M5_THERMAL2_CAPTURE_H_
+
+#include "M5_Thermal2.h"
+
+class M5_Thermal2_Capture {
+   public:
+    typedef M5_Thermal2::temperature_data_t temperature_data_t;
+
+    static constexpr uint8_t version      = 1;
+    static constexpr size_t header_size   = 8;
+    static constexpr uint8_t tag_subpage  = 0x01;
+    static constexpr uint8_t tag_key      = 0x02;
+    static constexpr uint8_t tag_overview = 0x04;
+    static constexpr uint8_t tag_coding   = 0x18;
+    static constexpr uint8_t coding_raw   = 0x00;
+    static constexpr uint8_t coding_rice  = 0x08;
+
+    static constexpr size_t pixel_count = M5_Thermal2::subpage_pixels;
+    static constexpr size_t raw_size    = pixel_count * 2;
+
+    /// Largest body: time delta, overview and a raw payload.
+    static constexpr size_t body_max =
+        5 + sizeof(M5_Thermal2::temperature_reg_t) + raw_size;
+};
+
+class M5_Thermal2_CaptureEncoder {
+   public:
+    typedef M5_Thermal2::temperature_data_t temperature_data_t;
+
+    /*! @brief Start a stream. Writes the stream header.
+        @return true:success / false:failure */
+    bool begin(Print* dst);
+
+    /*! @brief Records per subpage between key records.
+        @param records 0: only the first record of each subpage is a key. */
+    inline void setKeyInterval(uint16_t records) {
+        _key_interval = records;
+    }
+    /*! @brief Whether the overview (temperature_reg) is stored. (default) */
+    inline void setOverview(bool enable) {
+        _overview = enable;
+    }
+
+    /*! @brief Append a subpage.
+        @param usec Time stamp. (e.g. micros() when update() returned)
+        @return true:success / false:write failed, the stream restarts with
+                key records */
+    bool write(const temperature_data_t& src, uint32_t usec);
+
+    inline uint32_t getRecordCount(void) const {
+        return _records;
+    }
+    /*! @brief Bytes written, header included. */
+    inline uint32_t getBytesWritten(void) const {
+        return _bytes;
+    }
+
+   private:
+    Print* _dst            = nullptr;
+    uint32_t _records      = 0;
+    uint32_t _bytes        = 0;
+    uint32_t _prev_usec    = 0;
+    uint16_t _key_interval = 64;
+    uint16_t _since_key[2] = {0, 0};
+    bool _valid[2]         = {false, false};
+    bool _overview         = true;
+    uint16_t _prev[2][M5_Thermal2_Capture::pixel_count];
+    uint8_t _body[M5_Thermal2_Capture::body_max];
+
+    size_t _encodeRice(const uint16_t* pixel, const uint16_t* ref,
+                       uint8_t* dst, size_t limit);
+};
+
+class M5_Thermal2_CaptureDecoder {
+   public:
+    typedef M5_Thermal2::temperature_data_t temperature_data_t;
+
+    /*! @brief Start reading a stream. Reads and checks the stream header.
+        @return true:success / false:not a capture stream or newer version */
+    bool begin(Stream* src);
+
+    /*! @brief Read the next subpage.
+        @param usec Receives the time stamp given to the encoder.
+        @brief Without an overview in the stream, temperature_reg is zero.
+               Rows stale at recording time are stored as they were, so
+               stale_rows is zero.
+        @return true:success / false:end of stream or broken record */
+    bool read(temperature_data_t& dst, uint32_t* usec = nullptr);
+
+    inline uint8_t getVersion(void) const {
+        return _version;
+    }
+    inline uint32_t getRecordCount(void) const {
+        return _records;
+    }
+    /*! @brief Records skipped: unknown format, or a delta record without an
+               earlier key record of its subpage. */
+    inline uint32_t getSkippedCount(void) const {
+        return _skipped;
+    }
+
+   private:
+    Stream* _src      = nullptr;
+    uint32_t _records = 0;
+    uint32_t _skipped = 0;
+    uint32_t _usec    = 0;
+    uint8_t _version  = 0;
+    bool _valid[2]    = {false, false};
+    uint16_t _prev[2][M5_Thermal2_Capture::pixel_count];
+    uint8_t _body[M5_Thermal2_Capture::body_max];
+
+    bool _readVarint(uint32_t& value);
+    bool _decodeRice(const uint8_t* src, size_t len, const uint16_t* ref,
+                     uint16_t* pixel);
+};
+
+/*! @brief Plays a capture stream back through the update API of
+           M5_Thermal2, so code written against a live unit runs on a
+           recording. */
+class M5_Thermal2_Replay {
+   public:
+    typedef M5_Thermal2::temperature_data_t temperature_data_t;
+
+    /*! @brief Start a replay.
+        @param realtime true: subpages become available at their recorded
+                        pace. false: every update() returns the next one.
+        @return true:success / false:not a capture stream */
+    bool begin(Stream* src, bool realtime = true);
+
+    /*! @brief Same as M5_Thermal2::update().
+        @return true:new subpage / false:not due yet or end of the stream */
+    bool update(void);
+    bool update(temperature_data_t& dst);
+
+    inline const temperature_data_t& getTemperatureData(void) const {
+        return _latest;
+    }
+    /*! @brief Recorded time stamp of getTemperatureData(). */
+    inline uint32_t getRecordedMicros(void) const {
+        return _latest_usec;
+    }
+    inline bool isEnd(void) const {
+        return !_has_next;
+    }
+
+    /*! @brief micros() at which the next subpage becomes available. */
+    uint32_t nextFrameDueMicros(void) const;
+    /*! @brief Sleep until the next subpage is due. */
+    void waitForFrame(void);
+
+   private:
+    M5_Thermal2_CaptureDecoder _decoder;
+    temperature_data_t _latest = {};
+    temperature_data_t _next;
+    uint32_t _latest_usec = 0;
+    uint32_t _next_usec   = 0;
+    uint32_t _first_usec  = 0;  // recorded time stamp of the first record.
+    uint32_t _start_usec  = 0;  // micros() at begin().
+    bool _has_next        = false;
+    bool _realtime        = true;
+};
+
+#endif
@@ -0,0 +1,162 @@
+#include "M5_Thermal2_ClockGovernor.h"
+
+static constexpr uint32_t default_ladder[] = {100000, 200000, 400000,
+                                              600000, 800000, 1000000};
+
+// Step down only when the lower clock is estimated to use at most this share
+// of the budget, so the governor does not swing between two clocks.
+static constexpr uint32_t headroom_percent = 85;
+
+// Clean windows after which a clock that failed is allowed again. Doubled on
+// every failure, so a marginal clock is retried less and less often.
+static constexpr uint16_t min_recover_windows = 8;
+static constexpr uint16_t max_recover_windows = 256;
+
+bool M5_Thermal2_ClockGovernor::begin(M5_Thermal2* unit,
+                                      const uint32_t* ladder, size_t count) {
+    if (unit == nullptr) return false;
+    if (ladder == nullptr || count == 0) {
+        ladder = default_ladder;
+        count  = sizeof(default_ladder) / sizeof(default_ladder[0]);
+    }
+    // The pixel read never runs below the unit's base clock (setI2CFreq),
+    // so lower clocks are left out; the base clock is the lowest level.
+    uint32_t base = unit->getI2CFreq();
+    bool below    = false;
+    uint8_t n     = 0;
+    for (size_t i = 0; i < count && n < max_ladder; ++i) {
+        if (ladder[i] < base) {
+            below = true;
+            continue;
+        }
+        if (n == 0 && below && ladder[i] > base) _ladder[n++] = base;
+        if (n < max_ladder) _ladder[n++] = ladder[i];
+    }
+    if (n == 0) _ladder[n++] = base;
+    _unit    = unit;
+    _count   = n;
+    _ceiling = n - 1;
+
+    // Start from the clock the unit already uses.
+    uint8_t level = 0;
+    while (level + 1 < _count &&
+           _ladder[level + 1] <= unit->getI2CFreqPixelRead()) {
+        ++level;
+    }
+    _decisions = 0;
+    // The first failure doubles it to min_recover_windows.
+    _recover_windows = min_recover_windows / 2;
+    _apply(level, reason_start, 0);
+    return true;
+}
+
+void M5_Thermal2_ClockGovernor::setBudget(uint8_t percent) {
+    if (percent < 10) percent = 10;
+    if (percent > 100) percent = 100;
+    _budget = percent;
+}
+
+bool M5_Thermal2_ClockGovernor::update(bool frame_updated) {
+    if (_unit == nullptr) return false;
+
+    if (frame_updated) {
+        ++_frames;
+        _read_usec_sum += _unit->getPixelReadMicros();
+    }
+    uint32_t restarts = _unit->getPixelRestartCount() - _restart_base;
+    uint32_t dropped  = _unit->getChunkDroppedCount() - _dropped_base;
+
+    // A lost frame, or more than one restart per 8 frames, marks the clock as
+    // unreliable.
+    if (dropped || restarts * 8 > _window) {
+        _clean_windows = 0;
+        if (_recover_windows < max_recover_windows) _recover_windows <<= 1;
+        if (_level == 0) {
+            _apply(0, reason_failure, 0);
+            return false;
+        }
+        _ceiling = _level - 1;
+        _apply(_ceiling, reason_failure,
+               _frames ? _read_usec_sum / _frames : 0);
+        return true;
+    }
+    if (_frames < _window) return false;
+
+    uint32_t avg_usec = _read_usec_sum / _frames;
+    _frames           = 0;
+    _read_usec_sum    = 0;
+    _restart_base     = _unit->getPixelRestartCount();
+    _dropped_base     = _unit->getChunkDroppedCount();
+
+    if (restarts == 0 && ++_clean_windows >= _recover_windows) {
+        _clean_windows = 0;
+        if (_ceiling + 1 < _count) ++_ceiling;
+    }
+
+    uint32_t period_usec = 2000000u >> _unit->getRefreshRate();
+    uint32_t budget_usec = period_usec / 100 * _budget;
+    uint8_t level        = _level;
+    uint8_t reason       = reason_start;
+    if (avg_usec > budget_usec) {
+        if (_level < _ceiling) {
+            level  = _level + 1;
+            reason = reason_too_slow;
+        }
+    } else if (_level > 0 && _estimateMicros(avg_usec, _level - 1) * 100 <=
+                                 budget_usec * headroom_percent) {
+        level  = _level - 1;
+        reason = reason_headroom;
+    }
+    if (level == _level) return false;
+    _apply(level, reason, avg_usec);
+    return true;
+}
+
+bool M5_Thermal2_ClockGovernor::retune(void) {
+    if (_unit == nullptr) return false;
+    uint32_t usec = _unit->getPixelReadMicros();
+    if (usec == 0) return false;
+
+    // The clock update() would settle on: the lowest one that fits the
+    // budget with headroom, or the ceiling.
+    uint32_t period_usec = 2000000u >> _unit->getRefreshRate();
+    uint32_t budget_usec = period_usec / 100 * _budget;
+    uint8_t level        = 0;
+    while (level < _ceiling && _estimateMicros(usec, level) * 100 >
+                                   budget_usec * headroom_percent) {
+        ++level;
+    }
+    bool changed = (level != _level);
+    _apply(level, reason_rate, usec);
+    return changed;
+}
+
+const M5_Thermal2_ClockGovernor::decision_t*
+M5_Thermal2_ClockGovernor::getHistory(size_t index) const {
+    if (index >= getHistoryCount()) return nullptr;
+    return &_history[(_decisions - 1 - index) % history_size];
+}
+
+void M5_Thermal2_ClockGovernor::_apply(uint8_t level, uint8_t reason,
+                                       uint32_t pixel_read_usec) {
+    _frames        = 0;
+    _read_usec_sum = 0;
+    _restart_base  = _unit->getPixelRestartCount();
+    _dropped_base  = _unit->getChunkDroppedCount();
+    if (level == _level && reason != reason_start) return;
+
+    _level = level;
+    _unit->setI2CFreq(0, _ladder[level]);
+
+    auto& d           = _history[_decisions++ % history_size];
+    d.msec            = millis();
+    d.freq            = _unit->getI2CFreqPixelRead();  // as applied.
+    d.pixel_read_usec = (pixel_read_usec > 0xFFFF) ? 0xFFFF : pixel_read_usec;
+    d.reason          = reason;
+}
+
+uint32_t M5_Thermal2_ClockGovernor::_estimateMicros(uint32_t usec,
+                                                    uint8_t level) const {
+    // The pixel read is dominated by the bits on the wire.
+    return (uint64_t)usec * _ladder[_level] / _ladder[level];
+}
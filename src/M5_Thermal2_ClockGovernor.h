@@ -0,0 +1,112 @@
+/*!
+ * @brief Adaptive pixel read clock for Unit Thermal2.
+ * @copyright Copyright (c) 2022 by M5Stack[https://m5stack.com]
+ *
+ * Picks the pixel read I2C clock from a ladder of frequencies at runtime.
+ * It steps down to the lowest clock whose pixel read still fits the refresh
+ * period, steps up when the reads take too long, and backs off from clocks
+ * that produce chunk errors. A clock that failed is not tried again until
+ * the bus has been clean for a while.
+ */
+#ifndef _M5_THERMAL2_CLOCKGOVERNOR_H_
+#define _M5_THERMAL2_CLOCKGOVERNOR_H_
+
+#include "M5_Thermal2.h"
+
+class M5_Thermal2_ClockGovernor {
+   public:
+    enum reason_t : uint8_t {
+        reason_start,     // Initial clock.
+        reason_failure,   // Chunk errors, stepped down.
+        reason_too_slow,  // Pixel read exceeded the budget, stepped up.
+        reason_headroom,  // The next lower clock fits the budget.
+        reason_rate,      // Refresh rate changed, retuned.
+    };
+
+    /// One clock change.
+    struct decision_t {
+        uint32_t msec;             // millis() at the decision.
+        uint32_t freq;             // New pixel read clock.
+        uint16_t pixel_read_usec;  // Average pixel read time before it.
+        uint8_t reason;            // reason_t
+    };
+
+    static constexpr size_t history_size = 16;
+
+    /*! @brief Attach to a unit and apply the starting clock.
+        @param unit Unit whose pixel read clock is governed.
+        @param ladder Candidate clocks in ascending order. (copied, up to 8)
+                      Clocks below the unit's base clock (getI2CFreq) are
+                      replaced by it, as the pixel read cannot use them.
+                      Call setI2CFreq() before begin().
+        @param count Number of entries in ladder.
+        @return true:success / false:failure */
+    bool begin(M5_Thermal2* unit, const uint32_t* ladder = nullptr,
+               size_t count = 0);
+
+    /*! @brief Feed the result of M5_Thermal2::update().
+        @param frame_updated Return value of update(), or poll() returned
+                             update_done.
+        @return true: the pixel read clock was changed */
+    bool update(bool frame_updated);
+
+    /*! @brief Pick the clock for the unit's current refresh rate at once,
+               from the last pixel read time, instead of after a window.
+               Call after changing the refresh rate.
+        @return true: the pixel read clock was changed */
+    bool retune(void);
+
+    /*! @brief Share of the refresh period the pixel read may use.
+        @param percent 10~100 (default 60) */
+    void setBudget(uint8_t percent);
+
+    /*! @brief Frames per evaluation window. (default 32) */
+    inline void setWindow(uint16_t frames) {
+        _window = frames ? frames : 1;
+    }
+
+    /*! @brief Current pixel read clock. */
+    inline uint32_t getFreq(void) const {
+        return _ladder[_level];
+    }
+
+    /*! @brief Highest clock currently allowed. (lowered after errors) */
+    inline uint32_t getCeilingFreq(void) const {
+        return _ladder[_ceiling];
+    }
+
+    /*! @brief Number of stored decisions. (up to history_size) */
+    inline size_t getHistoryCount(void) const {
+        return (_decisions < history_size) ? _decisions : history_size;
+    }
+
+    /*! @brief Get a past decision.
+        @param index 0 = newest
+        @return decision / nullptr:out of range */
+    const decision_t* getHistory(size_t index) const;
+
+   private:
+    static constexpr size_t max_ladder = 8;
+
+    void _apply(uint8_t level, uint8_t reason, uint32_t pixel_read_usec);
+    uint32_t _estimateMicros(uint32_t usec, uint8_t level) const;
+
+    M5_Thermal2* _unit = nullptr;
+    uint32_t _ladder[max_ladder];
+    uint8_t _count   = 0;
+    uint8_t _level   = 0;
+    uint8_t _ceiling = 0;
+    uint8_t _budget  = 60;
+    uint16_t _window = 32;
+
+    uint16_t _frames          = 0;
+    uint32_t _read_usec_sum   = 0;
+    uint32_t _restart_base    = 0;
+    uint32_t _dropped_base    = 0;
+    uint16_t _clean_windows   = 0;
+    uint16_t _recover_windows = 8;
+    uint32_t _decisions       = 0;
+    decision_t _history[history_size];
+};
+
+#endif
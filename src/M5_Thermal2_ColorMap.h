@@ -0,0 +1,34 @@
+/*!
+ * @brief Colour maps for rendering Unit Thermal2 frames.
+ * @copyright Copyright (c) 2022 by M5Stack[https://m5stack.com]
+ *
+ * Each map has 256 RGB565 entries, from cold (index 0) to hot (index 255).
+ */
+#ifndef _M5_THERMAL2_COLORMAP_H_
+#define _M5_THERMAL2_COLORMAP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+class M5_Thermal2_ColorMap {
+   public:
+    enum color_map_t : uint8_t {
+        colormap_golden,
+        colormap_rainbow,
+        colormap_grayscale,
+        colormap_ironblack,
+        colormap_cam,
+        colormap_max,
+    };
+
+    static constexpr size_t table_size = 256;
+
+    /*! @brief Get a colour map.
+        @return 256 RGB565 colours / nullptr:unknown map */
+    static const uint16_t* getTable(color_map_t map);
+
+   private:
+    static const uint16_t _table[colormap_max][table_size];
+};
+
+#endif
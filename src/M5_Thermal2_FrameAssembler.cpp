@@ -0,0 +1,170 @@
+#include "M5_Thermal2_FrameAssembler.h"
+
+static constexpr uint_fast8_t frame_width  = M5_Thermal2::frame_width;
+static constexpr uint_fast8_t frame_height = M5_Thermal2::frame_height;
+static constexpr uint_fast8_t plane_width  = frame_width >> 1;
+
+// Interpolate a stale pixel on the frame border. (2 or 3 neighbours)
+static inline void fill_edge(uint16_t* __restrict frame,
+                             const uint16_t* __restrict value,
+                             const uint16_t* __restrict diff,
+                             uint_fast8_t x, uint_fast8_t y,
+                             uint32_t threshold) {
+    // In subpage coordinates the horizontal neighbours of the stale pixel x
+    // are (x-1)>>1 and (x+1)>>1, the vertical neighbours are x>>1.
+    uint_fast16_t i = y * plane_width;
+    uint32_t dsum   = 0;
+    uint32_t vsum   = 0;
+    uint32_t count  = 0;
+    if (x > 0) {
+        dsum += diff[i + ((x - 1) >> 1)];
+        vsum += value[i + ((x - 1) >> 1)];
+        ++count;
+    }
+    if (x < frame_width - 1) {
+        dsum += diff[i + ((x + 1) >> 1)];
+        vsum += value[i + ((x + 1) >> 1)];
+        ++count;
+    }
+    if (y > 0) {
+        dsum += diff[i - plane_width + (x >> 1)];
+        vsum += value[i - plane_width + (x >> 1)];
+        ++count;
+    }
+    if (y < frame_height - 1) {
+        dsum += diff[i + plane_width + (x >> 1)];
+        vsum += value[i + plane_width + (x >> 1)];
+        ++count;
+    }
+    if (dsum >= count * threshold) {
+        frame[x + y * frame_width] = (vsum + (count >> 1)) / count;
+    }
+}
+
+void M5_Thermal2_FrameAssembler::merge(const temperature_data_t& src,
+                                       uint16_t* __restrict frame,
+                                       uint16_t motion_threshold) {
+    const uint16_t* __restrict value = src.pixel_raw;
+    const bool subpage               = src.subpage;
+    const uint32_t stale             = src.stale_rows;
+    uint16_t diff[M5_Thermal2::subpage_pixels];
+
+    // De-interleave. In row y the subpage occupies x = 2k + ((y&1) != sp).
+    // Rows not read (stale) are left as they are.
+    for (uint_fast8_t y = 0; y < frame_height; ++y) {
+        if ((stale >> y) & 1) continue;
+        uint16_t* __restrict dst =
+            &frame[y * frame_width + ((y & 1) != subpage)];
+        const uint16_t* __restrict src_row = &value[y * plane_width];
+        uint16_t* __restrict diff_row      = &diff[y * plane_width];
+        for (uint_fast8_t k = 0; k < plane_width; ++k) {
+            int32_t v   = src_row[k];
+            int32_t d   = v - dst[k << 1];
+            diff_row[k] = (d < 0) ? -d : d;
+            dst[k << 1] = v;
+        }
+    }
+    if (motion_threshold == 0) return;
+
+    // Every neighbour of a stale pixel belongs to the new subpage, so the
+    // fill reads only `value` / `diff` and never its own output.
+    // Stale pixel k of row y sits at x = 2k + s, s = ((y&1) == sp).
+    // Its neighbours in subpage coordinates:
+    //   left k-1+s, right k+s (same row), up / down k (rows y-1 / y+1)
+    // Only rows whose vertical neighbours were read as well.
+    const uint32_t threshold4 = (uint32_t)motion_threshold << 2;
+    for (uint_fast8_t y = 1; y < frame_height - 1; ++y) {
+        if ((stale >> (y - 1)) & 7) continue;
+        const uint_fast8_t s              = ((y & 1) == subpage);
+        const uint16_t* __restrict v_mid  = &value[y * plane_width];
+        const uint16_t* __restrict v_up   = v_mid - plane_width;
+        const uint16_t* __restrict v_down = v_mid + plane_width;
+        const uint16_t* __restrict d_mid  = &diff[y * plane_width];
+        const uint16_t* __restrict d_up   = d_mid - plane_width;
+        const uint16_t* __restrict d_down = d_mid + plane_width;
+        uint16_t* __restrict out          = &frame[y * frame_width + s];
+
+        // Interior: k = 1-s .. 15-s, all four neighbours exist.
+        for (uint_fast8_t k = 1 - s; k < plane_width - s; ++k) {
+            uint32_t dsum = (uint32_t)d_mid[k - 1 + s] + d_mid[k + s] +
+                            d_up[k] + d_down[k];
+            uint32_t vsum = (uint32_t)v_mid[k - 1 + s] + v_mid[k + s] +
+                            v_up[k] + v_down[k];
+            uint16_t cur  = out[k << 1];
+            uint16_t avg  = (vsum + 2) >> 2;
+            out[k << 1]   = (dsum >= threshold4) ? avg : cur;
+        }
+        // Edge: x = 0 when s = 0, x = 31 when s = 1.
+        fill_edge(frame, value, diff, s ? frame_width - 1 : 0, y,
+                  motion_threshold);
+    }
+    // Top and bottom rows.
+    for (uint_fast8_t y = 0; y < frame_height; y += frame_height - 1) {
+        if ((stale >> (y ? y - 1 : 0)) & 3) continue;
+        const uint_fast8_t s = ((y & 1) == subpage);
+        for (uint_fast8_t x = s; x < frame_width; x += 2) {
+            fill_edge(frame, value, diff, x, y, motion_threshold);
+        }
+    }
+}
+
+bool M5_Thermal2_FrameAssembler::merge(const temperature_data_t& src) {
+    if (_merged == 0) {
+        // Nothing to interpolate from yet. Use the subpage for both halves.
+        for (uint_fast16_t i = 0; i < M5_Thermal2::subpage_pixels; ++i) {
+            if ((src.stale_rows >> (i >> 4)) & 1) continue;
+            _frame.pixel_raw[i << 1]       = src.pixel_raw[i];
+            _frame.pixel_raw[(i << 1) + 1] = src.pixel_raw[i];
+        }
+    } else {
+        merge(src, _frame.pixel_raw, _motion_threshold);
+    }
+    _frame.temperature_reg = src.temperature_reg;
+    _frame.subpage         = src.subpage;
+    _merged |= 1 << src.subpage;
+    _updateChangeMap();
+    return isComplete();
+}
+
+void M5_Thermal2_FrameAssembler::_updateChangeMap(void) {
+    if (_change_map == all_tiles) return;
+    const uint16_t* __restrict frame = _frame.pixel_raw;
+    const uint16_t* __restrict ref   = _reference;
+    const int32_t threshold          = _change_threshold;
+    for (uint_fast8_t ty = 0; ty < tile_rows; ++ty) {
+        // Bit per changed column within the tile row.
+        uint32_t columns = 0;
+        for (uint_fast8_t y = ty * tile_size; y < (ty + 1) * tile_size; ++y) {
+            const uint_fast16_t i = y * frame_width;
+            for (uint_fast8_t x = 0; x < frame_width; ++x) {
+                int32_t d = (int32_t)frame[i + x] - ref[i + x];
+                columns |= (uint32_t)((d > threshold) | (d < -threshold))
+                           << x;
+            }
+        }
+        // Fold each nibble into its lowest bit, then gather them.
+        columns |= columns >> 1;
+        columns |= columns >> 2;
+        uint32_t tiles = 0;
+        for (uint_fast8_t tx = 0; tx < tile_columns; ++tx) {
+            tiles |= ((columns >> (tx * tile_size)) & 1) << tx;
+        }
+        _change_map |= (uint64_t)tiles << (ty * tile_columns);
+    }
+}
+
+void M5_Thermal2_FrameAssembler::clearChangeMap(void) {
+    for (uint_fast8_t ty = 0; ty < tile_rows; ++ty) {
+        uint32_t tiles = (_change_map >> (ty * tile_columns)) & 0xFF;
+        if (tiles == 0) continue;
+        for (uint_fast8_t y = ty * tile_size; y < (ty + 1) * tile_size; ++y) {
+            for (uint_fast8_t tx = 0; tx < tile_columns; ++tx) {
+                if (!((tiles >> tx) & 1)) continue;
+                uint_fast16_t i = y * frame_width + tx * tile_size;
+                memcpy(&_reference[i], &_frame.pixel_raw[i],
+                       tile_size * sizeof(uint16_t));
+            }
+        }
+    }
+    _change_map = 0;
+}
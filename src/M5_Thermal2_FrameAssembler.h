@@ -0,0 +1,109 @@
+/*!
+ * @brief Full 32x24 frame assembler for Unit Thermal2 subpages.
+ * @copyright Copyright (c) 2022 by M5Stack[https://m5stack.com]
+ *
+ * Each update delivers one checkerboard subpage (384 pixels). The assembler
+ * writes it into the full frame and, where the scene moved, replaces the
+ * pixels of the other (stale) subpage with the average of their neighbours.
+ * Static areas keep the value from the previous subpage. Rows the update did
+ * not read (temperature_data_t::stale_rows) keep their previous content.
+ *
+ * The assembler also tracks which 4x4 pixel tiles changed since the consumer
+ * last looked (change map, 8x6 tiles in a uint64_t), so a renderer or an
+ * analysis can skip the static part of the scene.
+ */
+#ifndef _M5_THERMAL2_FRAMEASSEMBLER_H_
+#define _M5_THERMAL2_FRAMEASSEMBLER_H_
+
+#include "M5_Thermal2.h"
+
+class M5_Thermal2_FrameAssembler {
+   public:
+    typedef M5_Thermal2::temperature_data_t temperature_data_t;
+    typedef M5_Thermal2::frame_data_t frame_data_t;
+
+    /// Default motion threshold. (raw value, 128 = 1.0 degree Celsius)
+    static constexpr uint16_t default_motion_threshold = 128;
+    /// Default change threshold. (raw value, 32 = 0.25 degree Celsius)
+    static constexpr uint16_t default_change_threshold = 32;
+
+    static constexpr uint8_t tile_size    = 4;
+    static constexpr uint8_t tile_columns = M5_Thermal2::frame_width / 4;
+    static constexpr uint8_t tile_rows    = M5_Thermal2::frame_height / 4;
+
+    /*! @brief Merge a subpage into the full frame.
+        @return true: both subpages have been merged at least once */
+    bool merge(const temperature_data_t& src);
+
+    /*! @brief Merge a subpage into a caller-owned frame.
+        @param src Subpage obtained by M5_Thermal2::update().
+        @param frame 32x24 row major pixels holding the previous frame.
+        @param motion_threshold Average change of the neighbouring pixels
+                                (raw value) from which a stale pixel is
+                                interpolated. 0 disables interpolation. */
+    static void merge(const temperature_data_t& src, uint16_t* frame,
+                      uint16_t motion_threshold = default_motion_threshold);
+
+    /*! @brief Set the motion threshold. (raw value, 0 = no interpolation) */
+    inline void setMotionThreshold(uint16_t raw) {
+        _motion_threshold = raw;
+    }
+    inline uint16_t getMotionThreshold(void) const {
+        return _motion_threshold;
+    }
+
+    /*! @brief Set the change threshold. (raw value)
+        @brief A tile is marked when one of its pixels differs from the
+               value it had at the last clearChangeMap() by more than this. */
+    inline void setChangeThreshold(uint16_t raw) {
+        _change_threshold = raw;
+    }
+    inline uint16_t getChangeThreshold(void) const {
+        return _change_threshold;
+    }
+
+    /*! @brief Tiles changed since the last clearChangeMap().
+        @return bit (tx + ty * tile_columns) per tile. All set before the
+                first clearChangeMap(). */
+    inline uint64_t getChangeMap(void) const {
+        return _change_map;
+    }
+    inline bool isTileChanged(uint_fast8_t tx, uint_fast8_t ty) const {
+        return (_change_map >> (tx + ty * tile_columns)) & 1;
+    }
+    /*! @brief Take the marked tiles as seen (e.g. after drawing them). Their
+               current pixels become the reference for the next changes. */
+    void clearChangeMap(void);
+
+    /*! @brief Whether both subpages have been merged at least once. */
+    inline bool isComplete(void) const {
+        return _merged == 3;
+    }
+
+    /*! @brief Get the assembled frame. */
+    inline const frame_data_t& getFrame(void) const {
+        return _frame;
+    }
+
+    /*! @brief Forget the merged subpages. */
+    inline void reset(void) {
+        _merged     = 0;
+        _change_map = all_tiles;
+    }
+
+   private:
+    static constexpr uint64_t all_tiles =
+        (1ull << (tile_columns * tile_rows)) - 1;
+
+    frame_data_t _frame;
+    // Pixels as of the last clearChangeMap(), per tile.
+    uint16_t _reference[M5_Thermal2::frame_width * M5_Thermal2::frame_height];
+    uint64_t _change_map       = all_tiles;
+    uint16_t _motion_threshold = default_motion_threshold;
+    uint16_t _change_threshold = default_change_threshold;
+    uint8_t _merged            = 0;
+
+    void _updateChangeMap(void);
+};
+
+#endif
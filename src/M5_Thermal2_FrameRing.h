@@ -0,0 +1,150 @@
+/*!
+ * @brief Lock-free frame hand-off between an acquisition core and consumers.
+ * @copyright Copyright (c) 2022 by M5Stack[https://m5stack.com]
+ *
+ * M5_Thermal2_FrameRing    : single-producer / single-consumer FIFO.
+ * M5_Thermal2_TripleBuffer : always hands the latest complete frame.
+ *
+ * Neither side ever blocks or waits for the other. Use exactly one producer
+ * task and one consumer task per instance.
+ */
+#ifndef _M5_THERMAL2_FRAMERING_H_
+#define _M5_THERMAL2_FRAMERING_H_
+
+#include "M5_Thermal2.h"
+
+#include <atomic>
+#include <stddef.h>
+
+/*! @brief SPSC ring of frames.
+    @tparam T Frame type.
+    @tparam N Number of slots. One slot is always owned by the producer, so
+              up to N-1 frames can be queued. (power of 2, 2 or more) */
+template <typename T = M5_Thermal2::temperature_data_t, size_t N = 4>
+class M5_Thermal2_FrameRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of 2");
+
+   public:
+    /*! @brief (producer) Get the slot to fill with the next frame.
+        @brief Always succeeds. The slot belongs to the producer until
+               commitWrite() is called.
+        @return slot for writing */
+    inline T* beginWrite(void) {
+        return &_slot[_head.load(std::memory_order_relaxed) & (N - 1)];
+    }
+
+    /*! @brief (producer) Publish the slot obtained by beginWrite().
+        @return true:published / false:ring full, the frame was dropped and
+                the slot will be handed out again by beginWrite(). */
+    bool commitWrite(void) {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) >= N - 1) {
+            _drop_count.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*! @brief (consumer) Get the oldest unread frame.
+        @return frame / nullptr:no frame queued */
+    inline const T* beginRead(void) const {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) return nullptr;
+        return &_slot[tail & (N - 1)];
+    }
+
+    /*! @brief (consumer) Release the frame obtained by beginRead(). */
+    inline void endRead(void) {
+        _tail.store(_tail.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_release);
+    }
+
+    /*! @brief Number of queued frames. */
+    inline size_t available(void) const {
+        return _head.load(std::memory_order_acquire) -
+               _tail.load(std::memory_order_acquire);
+    }
+
+    /*! @brief Number of published frames. */
+    inline uint32_t getWriteCount(void) const {
+        return _head.load(std::memory_order_relaxed);
+    }
+
+    /*! @brief Number of frames dropped because the ring was full. */
+    inline uint32_t getDropCount(void) const {
+        return _drop_count.load(std::memory_order_relaxed);
+    }
+
+   private:
+    T _slot[N];
+    std::atomic<size_t> _head{0};
+    std::atomic<size_t> _tail{0};
+    std::atomic<uint32_t> _drop_count{0};
+};
+
+/*! @brief Triple buffer. The consumer always gets the latest complete frame.
+    @tparam T Frame type. */
+template <typename T = M5_Thermal2::temperature_data_t>
+class M5_Thermal2_TripleBuffer {
+   public:
+    /*! @brief (producer) Get the slot to fill with the next frame.
+        @return slot for writing */
+    inline T* beginWrite(void) {
+        return &_slot[_write];
+    }
+
+    /*! @brief (producer) Publish the slot obtained by beginWrite().
+        @brief If the previously published frame was not read yet it is
+               replaced, and the overrun counter is incremented. */
+    void commitWrite(void) {
+        uint8_t prev = _middle.exchange(_write | fresh_flag,
+                                        std::memory_order_acq_rel);
+        _write       = prev & index_mask;
+        if (prev & fresh_flag) {
+            _overrun_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        _write_count.fetch_add(1, std::memory_order_release);
+    }
+
+    /*! @brief (consumer) Take the latest complete frame.
+        @brief The returned frame stays valid and unchanged until the next
+               call of beginRead().
+        @return frame / nullptr:no new frame since the last call */
+    const T* beginRead(void) {
+        if (!(_middle.load(std::memory_order_relaxed) & fresh_flag)) {
+            return nullptr;
+        }
+        uint8_t prev = _middle.exchange(_read, std::memory_order_acq_rel);
+        _read        = prev & index_mask;
+        return &_slot[_read];
+    }
+
+    /*! @brief (consumer) The frame taken by the last beginRead(). */
+    inline const T* latest(void) const {
+        return &_slot[_read];
+    }
+
+    /*! @brief Number of published frames. */
+    inline uint32_t getWriteCount(void) const {
+        return _write_count.load(std::memory_order_acquire);
+    }
+
+    /*! @brief Number of frames replaced before the consumer took them. */
+    inline uint32_t getOverrunCount(void) const {
+        return _overrun_count.load(std::memory_order_relaxed);
+    }
+
+   private:
+    static constexpr uint8_t index_mask = 0x03;
+    static constexpr uint8_t fresh_flag = 0x04;
+
+    T _slot[3];
+    uint8_t _write = 0;  // Owned by the producer.
+    uint8_t _read  = 2;  // Owned by the consumer.
+    std::atomic<uint8_t> _middle{1};
+    std::atomic<uint32_t> _write_count{0};
+    std::atomic<uint32_t> _overrun_count{0};
+};
+
+#endif
@@ -0,0 +1,158 @@
+#include "M5_Thermal2_Histogram.h"
+
+#include <string.h>
+
+static constexpr uint8_t bin_shift = M5_Thermal2_Histogram::bin_shift;
+static constexpr uint32_t bin_mask = (1u << bin_shift) - 1;
+
+void M5_Thermal2_Histogram::update(const uint16_t* pixels, size_t count) {
+    if (_count) {
+        // Only the bins between the previous lowest and highest were used.
+        size_t first = _lowest >> bin_shift;
+        memset(&_bin[first], 0,
+               ((_highest >> bin_shift) - first + 1) * sizeof(_bin[0]));
+    }
+    uint_fast16_t lowest  = UINT16_MAX;
+    uint_fast16_t highest = 0;
+    uint32_t sum          = 0;
+    for (size_t i = 0; i < count; ++i) {
+        uint_fast16_t v = pixels[i];
+        ++_bin[v >> bin_shift];
+        sum += v;
+        if (lowest > v) lowest = v;
+        if (highest < v) highest = v;
+    }
+    _count   = count;
+    _sum     = sum;
+    _lowest  = count ? lowest : 0;
+    _highest = highest;
+    _updateGain();
+}
+
+uint16_t M5_Thermal2_Histogram::_rankToRaw(uint32_t rank) const {
+    // rank: pixels below the result, scaled by 65535.
+    if (_count == 0) return 0;
+    uint32_t target = (uint64_t)rank * _count / 65535;
+    size_t b        = _lowest >> bin_shift;
+    size_t last     = _highest >> bin_shift;
+    uint32_t cum    = 0;
+    while (b < last && cum + _bin[b] <= target) {
+        cum += _bin[b++];
+    }
+    uint32_t raw = b << bin_shift;
+    if (_bin[b]) {
+        raw += ((target - cum) << bin_shift) / _bin[b];
+    }
+    return (raw < _lowest) ? _lowest : (raw > _highest) ? _highest : raw;
+}
+
+uint16_t M5_Thermal2_Histogram::getPercentile(float percent) const {
+    if (percent <= 0.0f) return _lowest;
+    if (percent >= 100.0f) return _highest;
+    return _rankToRaw(percent * 655.35f);
+}
+
+void M5_Thermal2_Histogram::setAutoGain(float low_percent, float high_percent,
+                                        uint16_t min_span_raw,
+                                        uint8_t smoothing) {
+    auto rank = [](float percent) -> uint16_t {
+        return (percent <= 0.0f)     ? 0
+               : (percent >= 100.0f) ? 65535
+                                     : (uint16_t)(percent * 655.35f);
+    };
+    _gain_low_rank  = rank(low_percent);
+    _gain_high_rank = rank(high_percent);
+    _gain_min_span  = min_span_raw;
+    _gain_smoothing = (smoothing > 7) ? 7 : smoothing;
+    _gain_valid     = false;
+}
+
+void M5_Thermal2_Histogram::_updateGain(void) {
+    if (_count == 0) return;
+    int32_t low  = _rankToRaw(_gain_low_rank);
+    int32_t high = _rankToRaw(_gain_high_rank);
+    int32_t lack = _gain_min_span - (high - low);
+    if (lack > 0) {
+        low -= lack >> 1;
+        high += lack - (lack >> 1);
+    }
+    low <<= 8;
+    high <<= 8;
+    if (!_gain_valid) {
+        _gain_valid = true;
+        _gain_low   = low;
+        _gain_high  = high;
+        return;
+    }
+    _gain_low += (low - _gain_low) >> _gain_smoothing;
+    _gain_high += (high - _gain_high) >> _gain_smoothing;
+}
+
+void M5_Thermal2_Histogram::getHistogram(int32_t raw_lowest,
+                                         int32_t raw_highest, uint16_t* dst,
+                                         size_t count) const {
+    if (count == 0) return;
+    memset(dst, 0, count * sizeof(dst[0]));
+    if (_count == 0) return;
+    int32_t span = raw_highest - raw_lowest + 1;
+    if (span < 1) span = 1;
+    int32_t last = count - 1;
+    // A bin's count is spread evenly over the slices its raw values fall
+    // in, so slices narrower than a bin are not left empty in turns.
+    // Positions are in slices x span. (16.16)
+    size_t first = _lowest >> bin_shift;
+    int64_t step = (int64_t)count << (16 + bin_shift);
+    int64_t pos  = ((int64_t)(first << bin_shift) - raw_lowest) * count * 65536;
+    for (size_t b = first; b <= (_highest >> bin_shift); ++b, pos += step) {
+        uint32_t n = _bin[b];
+        if (n == 0) continue;
+        int64_t s0     = pos / span;
+        int64_t s1     = (pos + step) / span;
+        int32_t i      = (s0 < 0) ? 0 : (int32_t)(s0 >> 16);
+        uint32_t given = 0;
+        if (i > last) i = last;
+        for (;; ++i) {
+            int64_t end = (int64_t)(i + 1) << 16;
+            if (i == last || end >= s1) {
+                dst[i] += n - given;
+                break;
+            }
+            // Pixels up to the end of slice i, rounded.
+            uint32_t upto = (n * (end - s0) + ((s1 - s0) >> 1)) / (s1 - s0);
+            dst[i] += upto - given;
+            given = upto;
+        }
+    }
+}
+
+void M5_Thermal2_Histogram::getEqualizationLut(int32_t raw_lowest,
+                                               int32_t raw_highest,
+                                               uint8_t* lut) const {
+    int32_t span = raw_highest - raw_lowest + 1;
+    if (span < 1) span = 1;
+    if (_count == 0) {
+        for (size_t i = 0; i < lut_size; ++i) lut[i] = i;
+        return;
+    }
+    // colour index per pixel count. (16.16)
+    uint32_t mul = (255u << 16) / _count;
+    size_t b     = _lowest >> bin_shift;
+    uint32_t cum = 0;  // pixels in the bins below b.
+    for (size_t i = 0; i < lut_size; ++i) {
+        int32_t raw = raw_lowest + ((int32_t)i * span >> 8);
+        uint32_t below;
+        if (raw < _lowest) {
+            below = 0;
+        } else if (raw >= _highest) {
+            below = _count;
+        } else {
+            size_t target = raw >> bin_shift;
+            while (b < target) {
+                cum += _bin[b++];
+            }
+            // Part of the bin at or below raw.
+            below = cum + ((_bin[b] * ((raw & bin_mask) + 1)) >> bin_shift);
+        }
+        lut[i] = (below * mul + 0x8000) >> 16;
+    }
+}
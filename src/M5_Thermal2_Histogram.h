@@ -0,0 +1,111 @@
+/*!
+ * @brief Histogram, percentile and auto-gain engine for Unit Thermal2.
+ * @copyright Copyright (c) 2022 by M5Stack[https://m5stack.com]
+ *
+ * One pass over the raw pixels counts them into fixed-width bins (counting
+ * sort) and tracks lowest, highest and sum. Percentiles, a robust display
+ * range, resampled histograms and an equalisation LUT are then read from the
+ * bins without touching the pixels again. Only the bins between the lowest
+ * and highest value are walked or cleared, so the cost follows the scene's
+ * temperature span rather than the bin count.
+ *
+ * A bin holds 16 raw values (0.125 degree Celsius, 8 KB of bins); one per raw
+ * value would take 128 KB. Within a bin the pixels are taken as evenly
+ * spread: percentiles are interpolated and may be off by up to 15 raw
+ * (0.12 degree Celsius) from a full sort, and getHistogram() spreads a bin
+ * over the slices it covers. Lowest, highest and average are exact.
+ */
+#ifndef _M5_THERMAL2_HISTOGRAM_H_
+#define _M5_THERMAL2_HISTOGRAM_H_
+
+#include "M5_Thermal2.h"
+
+class M5_Thermal2_Histogram {
+   public:
+    /// Raw values per bin: 1 << bin_shift. (16 = 0.125 degree Celsius)
+    static constexpr uint8_t bin_shift = 4;
+    static constexpr size_t bin_count  = 65536 >> bin_shift;
+    static constexpr size_t lut_size   = 256;
+
+    /*! @brief Count a frame or subpage.
+        @param pixels raw values. (pixel_raw of temperature_data_t or
+                      frame_data_t)
+        @param count number of pixels. (384 or 768, up to 65535) */
+    void update(const uint16_t* pixels, size_t count);
+
+    /*! @brief Raw value below which the given share of the pixels lies.
+        @param percent 0.0 ~ 100.0
+        @return raw value, interpolated within the bin. (within 15 raw of
+                the exact percentile) */
+    uint16_t getPercentile(float percent) const;
+
+    inline uint16_t getLowest(void) const {
+        return _lowest;
+    }
+    inline uint16_t getHighest(void) const {
+        return _highest;
+    }
+    inline uint16_t getAverage(void) const {
+        return _count ? _sum / _count : 0;
+    }
+    inline uint16_t getCount(void) const {
+        return _count;
+    }
+
+    /*! @brief Set up the auto-gain range.
+        @param low_percent Percentile drawn as the coldest colour.
+        @param high_percent Percentile drawn as the hottest colour.
+        @param min_span_raw Smallest range. (raw, 128 = 1.0 degree Celsius)
+        @param smoothing 0 (follow at once) ~ 7 (slow). The range moves by
+                         1/2^smoothing of the distance each update. */
+    void setAutoGain(float low_percent, float high_percent,
+                     uint16_t min_span_raw = 128, uint8_t smoothing = 2);
+
+    /*! @brief Auto-gain range after the last update(). (raw) */
+    inline int32_t getGainLowest(void) const {
+        return _gain_low >> 8;
+    }
+    inline int32_t getGainHighest(void) const {
+        return _gain_high >> 8;
+    }
+
+    /*! @brief Resample the counts into equal slices of a raw range.
+        @brief Values outside the range are counted in the first / last
+               slice. A bin's count is shared by the slices it overlaps,
+               so slices narrower than a bin (16 raw) get its average.
+        @param raw_lowest Start of the first slice.
+        @param raw_highest End of the last slice.
+        @param dst Receives count slices.
+        @param count number of slices. */
+    void getHistogram(int32_t raw_lowest, int32_t raw_highest, uint16_t* dst,
+                      size_t count) const;
+
+    /*! @brief Histogram equalisation LUT for a display range.
+        @brief Index i stands for the raw value lowest + i * span / 256, as
+               drawn by M5_Thermal2_Renderer::setRange(). The entry is the
+               equalised colour index, so a colour map can be remapped with
+               map[lut[i]].
+        @param lut Receives lut_size entries. */
+    void getEqualizationLut(int32_t raw_lowest, int32_t raw_highest,
+                            uint8_t* lut) const;
+
+   private:
+    uint16_t _bin[bin_count] = {};
+    uint16_t _lowest         = 0;
+    uint16_t _highest        = 0;
+    uint16_t _count          = 0;
+    uint32_t _sum            = 0;
+
+    uint16_t _gain_low_rank  = 0;  // percent * 655.35
+    uint16_t _gain_high_rank = 65535;
+    uint16_t _gain_min_span  = 128;
+    uint8_t _gain_smoothing  = 2;
+    bool _gain_valid         = false;
+    int32_t _gain_low        = 0;  // raw << 8
+    int32_t _gain_high       = 0;
+
+    uint16_t _rankToRaw(uint32_t rank) const;
+    void _updateGain(void);
+};
+
+#endif
@@ -0,0 +1,246 @@
+#include "M5_Thermal2_History.h"
+
+typedef M5_Thermal2_History hist;
+
+// Prediction of the first pixel of a key record. (0 degree Celsius)
+static constexpr uint16_t key_origin = 64 * 128;
+// Width code of a block holding 16 bit residuals.
+static constexpr uint8_t width_full = 15;
+
+static inline uint16_t zigzag(int16_t v) {
+    return ((uint16_t)v << 1) ^ (uint16_t)(v >> 15);
+}
+static inline int16_t unzigzag(uint16_t v) {
+    return (int16_t)((v >> 1) ^ -(int16_t)(v & 1));
+}
+
+static inline uint8_t block_width(const uint8_t* widths, uint_fast8_t b) {
+    uint8_t code = (widths[b >> 1] >> ((b & 1) * 4)) & 0x0F;
+    return (code == width_full) ? 16 : code;
+}
+
+static size_t record_size(const uint8_t* rec) {
+    const uint8_t* widths = &rec[hist::header_size];
+    size_t len            = hist::header_size + hist::widths_size;
+    for (uint_fast8_t b = 0; b < hist::block_count; ++b) {
+        len += block_width(widths, b) * 2;
+    }
+    return len;
+}
+
+bool M5_Thermal2_History::begin(uint8_t* buffer, size_t size,
+                                uint16_t frames) {
+    size_t index_size = frames * sizeof(uint32_t);
+    // The index is placed at a 4 byte boundary.
+    size_t skew = (4 - ((uintptr_t)buffer & 3)) & 3;
+    if (buffer == nullptr || frames < 2 ||
+        size < skew + index_size + record_max * 2) {
+        _data = nullptr;
+        return false;
+    }
+    _index    = (uint32_t*)(buffer + skew);
+    _data     = buffer + skew + index_size;
+    _capacity = size - skew - index_size;
+    _frames   = frames;
+    clear();
+    return true;
+}
+
+void M5_Thermal2_History::clear(void) {
+    _first          = 0;
+    _next           = 0;
+    _group          = 0;
+    _head           = 0;
+    _used           = 0;
+    _cache_valid[0] = false;
+    _cache_valid[1] = false;
+}
+
+// Encodes a record into _record. Residuals are against the previous subpage
+// of the same parity or, for a key, against the previous pixel.
+size_t M5_Thermal2_History::_encode(const temperature_data_t& src,
+                                    uint32_t usec, uint8_t flags) {
+    const uint16_t* ref =
+        (flags & flag_key) ? nullptr : _prev[flags & flag_subpage];
+    uint8_t* rec = _record;
+    rec[0]       = flags;
+    memcpy(&rec[1], &usec, 4);
+    memcpy(&rec[5], &src.temperature_reg, sizeof(src.temperature_reg));
+    memcpy(&rec[header_size - 3], &src.stale_rows, 3);  // little endian.
+
+    uint8_t* widths = &rec[header_size];
+    uint8_t* dst    = widths + widths_size;
+    memset(widths, 0, widths_size);
+    uint16_t prev = key_origin;
+    for (uint_fast8_t b = 0; b < block_count; ++b) {
+        const uint16_t* pixel = &src.pixel_raw[b * block_size];
+        uint16_t residual[block_size];
+        uint16_t all = 0;
+        for (uint_fast8_t i = 0; i < block_size; ++i) {
+            uint16_t p  = ref ? ref[b * block_size + i] : prev;
+            residual[i] = zigzag(pixel[i] - p);
+            prev        = pixel[i];
+            all |= residual[i];
+        }
+        uint8_t width = all ? 32 - __builtin_clz(all) : 0;
+        if (width >= width_full) width = 16;
+        widths[b >> 1] |= (width == 16 ? width_full : width) << ((b & 1) * 4);
+        if (width == 0) continue;
+
+        // 16 values of width bits: exactly 2 x width bytes.
+        uint32_t acc = 0;
+        uint8_t bits = 0;
+        for (uint_fast8_t i = 0; i < block_size; ++i) {
+            acc |= (uint32_t)residual[i] << bits;
+            bits += width;
+            while (bits >= 8) {
+                *dst++ = acc;
+                acc >>= 8;
+                bits -= 8;
+            }
+        }
+    }
+    return dst - rec;
+}
+
+// Applies the residuals of a record to pixel. (in place)
+static void decode(const uint8_t* rec, uint16_t* pixel) {
+    const uint8_t* widths = &rec[hist::header_size];
+    const uint8_t* src    = widths + hist::widths_size;
+    const bool key        = rec[0] & hist::flag_key;
+    uint16_t prev         = key_origin;
+    for (uint_fast8_t b = 0; b < hist::block_count; ++b) {
+        uint16_t* dst       = &pixel[b * hist::block_size];
+        const uint8_t width = block_width(widths, b);
+        const uint32_t mask = (1u << width) - 1;
+        uint32_t acc        = 0;
+        uint8_t bits        = 0;
+        for (uint_fast8_t i = 0; i < hist::block_size; ++i) {
+            while (bits < width) {
+                acc |= (uint32_t)*src++ << bits;
+                bits += 8;
+            }
+            int16_t r = unzigzag(acc & mask);
+            acc >>= width;
+            bits -= width;
+            dst[i] = (key ? prev : dst[i]) + r;
+            prev   = dst[i];
+        }
+    }
+}
+
+void M5_Thermal2_History::_evictGroup(void) {
+    do {
+        _used -= record_size(&_data[_offsetOf(_first)]);
+        ++_first;
+    } while (_first != _next && !(_data[_offsetOf(_first)] & flag_group));
+}
+
+// Finds room for len bytes after the newest record, or at the start of the
+// ring, evicting the oldest groups until there is.
+void M5_Thermal2_History::_reserve(size_t len, uint32_t& offset) {
+    for (;;) {
+        if (size() == 0) {
+            _head  = 0;
+            offset = 0;
+            return;
+        }
+        if (size() < _frames) {
+            // The head never reaches the tail from below, so head == tail
+            // only when empty.
+            uint32_t tail = _offsetOf(_first);
+            if (_head > tail) {
+                if (_capacity - _head >= len) {
+                    offset = _head;
+                    return;
+                }
+                if (len < tail) {
+                    offset = 0;
+                    return;
+                }
+            } else if (tail - _head > len) {
+                offset = _head;
+                return;
+            }
+        }
+        _evictGroup();
+    }
+}
+
+bool M5_Thermal2_History::append(const temperature_data_t& src,
+                                 uint32_t usec) {
+    if (_data == nullptr) return false;
+    const uint8_t sp = src.subpage ? flag_subpage : 0;
+    bool start       = size() == 0 || _next - _group >= _key_interval;
+
+    uint32_t offset;
+    size_t len;
+    for (;;) {
+        uint8_t flags = sp;
+        if (start || !_in_group[sp]) flags |= flag_key;
+        if (start) flags |= flag_group;
+        len = _encode(src, usec, flags);
+        _reserve(len, offset);
+        // Making room may have evicted the group this record refers to.
+        if (start || _first <= _group) break;
+        start = true;
+    }
+
+    memcpy(&_data[offset], _record, len);
+    _index[_next % _frames] = offset;
+    _head                   = offset + len;
+    _used += len;
+    if (start) {
+        _group       = _next;
+        _in_group[0] = false;
+        _in_group[1] = false;
+    }
+    _in_group[sp] = true;
+    memcpy(_prev[sp], src.pixel_raw, sizeof(_prev[sp]));
+    ++_next;
+    return true;
+}
+
+bool M5_Thermal2_History::read(uint32_t age, temperature_data_t& dst,
+                               uint32_t* usec) {
+    if (age >= size()) return false;
+    const uint32_t seq = _next - 1 - age;
+    const uint8_t* rec = &_data[_offsetOf(seq)];
+    const uint8_t sp   = rec[0] & flag_subpage;
+    uint16_t* pixel    = _cache[sp];
+
+    // Back to the key of this subpage, or to the decoded one kept from the
+    // last read when it is on the way.
+    uint32_t s = seq;
+    for (;; --s) {
+        const uint8_t* r = &_data[_offsetOf(s)];
+        if ((r[0] & flag_subpage) != sp) continue;
+        if (_cache_valid[sp] && _cache_seq[sp] == s) break;
+        if (r[0] & flag_key) {
+            decode(r, pixel);
+            break;
+        }
+    }
+    // Forward through the deltas.
+    while (s != seq) {
+        const uint8_t* r = &_data[_offsetOf(++s)];
+        if ((r[0] & flag_subpage) == sp) decode(r, pixel);
+    }
+    _cache_seq[sp]   = seq;
+    _cache_valid[sp] = true;
+
+    memcpy(dst.pixel_raw, pixel, sizeof(dst.pixel_raw));
+    memcpy(&dst.temperature_reg, &rec[5], sizeof(dst.temperature_reg));
+    dst.stale_rows = 0;
+    memcpy(&dst.stale_rows, &rec[header_size - 3], 3);
+    dst.subpage = sp;
+    if (usec) memcpy(usec, &rec[1], 4);
+    return true;
+}
+
+uint32_t M5_Thermal2_History::getMicros(uint32_t age) const {
+    if (age >= size()) return 0;
+    uint32_t usec;
+    memcpy(&usec, &_data[_offsetOf(_next - 1 - age) + 1], 4);
+    return usec;
+}
@@ -0,0 +1,137 @@
+/*!
+ * @brief Delta-compressed in-RAM history of Unit Thermal2 subpages.
+ * @copyright Copyright (c) 2022 by M5Stack[https://m5stack.com]
+ *
+ * Keeps the most recent subpages in a caller-provided buffer, for rewinding
+ * and for capturing the seconds before an alarm. The buffer holds an index
+ * (4 bytes per retained subpage) and a byte ring of records:
+ *
+ *   record : flags(1) usec(4) temperature_reg_t(16) stale_rows(3)
+ *            widths(12) payload
+ *
+ *   flags bit 0 : subpage
+ *         bit 1 : key. Pixels are predicted from the previous pixel of the
+ *                 record instead of the previous subpage of the same parity.
+ *         bit 2 : group start.
+ *
+ *   payload : the prediction residuals (mod 2^16, zigzag) in 24 blocks of
+ *             16 pixels, each packed LSB first with the width (4 bits in
+ *             widths, 15 meaning 16) of the largest one in the block. A
+ *             block of width w takes 2 x w bytes: a static block none, a
+ *             noisy one a few bits per pixel (nibbles for +-8), an edge
+ *             that moved up to 16 bits.
+ *
+ * Records come in groups of setKeyInterval() subpages; the first record of
+ * each subpage in a group is a key, the others refer to the previous record
+ * of their subpage in the same group. Whole groups are evicted, oldest
+ * first, so every retained record can be decoded:
+ *   - append : encode (768 pixels), plus O(1) per evicted subpage
+ *   - read   : the records of the subpage from its key, at most the key
+ *              interval; reading forward one subpage at a time (playback)
+ *              decodes one record, the previous result is kept.
+ */
+#ifndef _M5_THERMAL2_HISTORY_H_
+#define _M5_THERMAL2_HISTORY_H_
+
+#include "M5_Thermal2.h"
+
+class M5_Thermal2_History {
+   public:
+    typedef M5_Thermal2::temperature_data_t temperature_data_t;
+
+    static constexpr uint8_t flag_subpage = 0x01;
+    static constexpr uint8_t flag_key     = 0x02;
+    static constexpr uint8_t flag_group   = 0x04;
+
+    static constexpr size_t pixel_count = M5_Thermal2::subpage_pixels;
+    static constexpr size_t block_size  = 16;
+    static constexpr size_t block_count = pixel_count / block_size;
+    static constexpr size_t header_size =
+        1 + 4 + sizeof(M5_Thermal2::temperature_reg_t) + 3;
+    static constexpr size_t widths_size = block_count / 2;
+    /// Largest record: every block 16 bits wide.
+    static constexpr size_t record_max =
+        header_size + widths_size + pixel_count * 2;
+
+    /*! @brief Use a buffer. Its first frames x 4 bytes hold the index.
+        @param buffer storage, owned by the caller. (static, heap or PSRAM)
+        @param size bytes, room for the index and 2 x record_max at least
+        @param frames most subpages retained.
+        @return true:success / false:failure */
+    bool begin(uint8_t* buffer, size_t size, uint16_t frames = 1024);
+
+    /*! @brief Subpages per group. A shorter group makes reads cheaper and
+               eviction finer, a longer one stores fewer keys.
+        @param frames default 64, 2 or more */
+    inline void setKeyInterval(uint16_t frames) {
+        _key_interval = (frames < 2) ? 2 : frames;
+    }
+
+    /*! @brief Append a subpage. The oldest groups are evicted as needed.
+        @param usec Time stamp. (e.g. micros() when update() returned)
+        @return true:success / false:not started */
+    bool append(const temperature_data_t& src, uint32_t usec);
+
+    /*! @brief Read a retained subpage.
+        @param age 0:newest to size()-1:oldest
+        @param usec Receives the time stamp given to append().
+        @return true:success / false:no such subpage */
+    bool read(uint32_t age, temperature_data_t& dst,
+              uint32_t* usec = nullptr);
+
+    /*! @brief Time stamp of a retained subpage, without decoding it.
+        @param age 0:newest to size()-1:oldest */
+    uint32_t getMicros(uint32_t age) const;
+
+    /*! @brief Number of retained subpages. */
+    inline uint32_t size(void) const {
+        return _next - _first;
+    }
+    /*! @brief Bytes taken by the retained records. */
+    inline uint32_t getBytesUsed(void) const {
+        return _used;
+    }
+    /*! @brief Average record size of the retained subpages. (bytes) */
+    inline float getBytesPerFrame(void) const {
+        return size() ? (float)_used / size() : 0.0f;
+    }
+    /*! @brief Subpages evicted since begin(). */
+    inline uint32_t getEvictedCount(void) const {
+        return _first;
+    }
+
+    /*! @brief Drop all subpages. */
+    void clear(void);
+
+   private:
+    uint32_t* _index       = nullptr;  // record offset per retained subpage.
+    uint8_t* _data         = nullptr;
+    uint32_t _capacity     = 0;  // data bytes.
+    uint16_t _frames       = 0;
+    uint16_t _key_interval = 64;
+
+    // Sequence numbers. _first: oldest retained, _next: next appended.
+    uint32_t _first   = 0;
+    uint32_t _next    = 0;
+    uint32_t _group   = 0;  // first of the group being written.
+    uint32_t _head    = 0;  // data offset of the next record.
+    uint32_t _used    = 0;
+    bool _in_group[2] = {false, false};
+    uint16_t _prev[2][pixel_count];  // last appended pixels per subpage.
+    uint8_t _record[record_max];
+
+    // Last decoded subpage per parity, so playback decodes one record.
+    uint32_t _cache_seq[2] = {0, 0};
+    bool _cache_valid[2]   = {false, false};
+    uint16_t _cache[2][pixel_count];
+
+    inline uint32_t _offsetOf(uint32_t seq) const {
+        return _index[seq % _frames];
+    }
+    size_t _encode(const temperature_data_t& src, uint32_t usec,
+                   uint8_t flags);
+    void _reserve(size_t len, uint32_t& offset);
+    void _evictGroup(void);
+};
+
+#endif
@@ -0,0 +1,248 @@
+#include "M5_Thermal2_NonUniformity.h"
+
+static constexpr uint8_t width      = M5_Thermal2::frame_width;
+static constexpr uint8_t height     = M5_Thermal2::frame_height;
+static constexpr uint8_t row_pixels = width / 2;  // per subpage.
+// Estimator state limits: offsets stay within int16_t.
+static constexpr int32_t estimate_max = (int32_t)INT16_MAX * 256;
+static constexpr int32_t estimate_min = (int32_t)INT16_MIN * 256;
+// Leak of the estimator, slower than its rate by this shift.
+static constexpr uint8_t leak_shift = 4;
+// Marks a pixel the estimator left alone.
+static constexpr int32_t no_step = INT32_MIN;
+
+// raw + offset, saturated to the range of raw.
+static inline uint16_t add_sat(uint16_t raw, int16_t offset) {
+    const int32_t v = (int32_t)raw + offset;
+    return (v < 0) ? 0 : (v > UINT16_MAX) ? UINT16_MAX : v;
+}
+
+// Subpage index of a pixel. (x + y of its parity)
+static inline uint_fast16_t index_of(uint_fast8_t x, uint_fast8_t y) {
+    return y * row_pixels + (x >> 1);
+}
+
+M5_Thermal2_NonUniformity::M5_Thermal2_NonUniformity(void) {
+    clear();
+}
+
+void M5_Thermal2_NonUniformity::clear(void) {
+    memset(_offset, 0, sizeof(_offset));
+    memset(_reference, 0, sizeof(_reference));
+    memset(_estimate, 0, sizeof(_estimate));
+    _flat_target = 0;
+    _primed      = 0;
+}
+
+void M5_Thermal2_NonUniformity::setEstimatorParam(uint8_t rate_shift,
+                                                  uint16_t limit_raw,
+                                                  uint16_t motion_raw) {
+    if (rate_shift < 1) rate_shift = 1;
+    if (rate_shift > 15) rate_shift = 15;
+    _rate_shift = rate_shift;
+    _limit_raw  = limit_raw;
+    _motion_raw = motion_raw;
+}
+
+void M5_Thermal2_NonUniformity::apply(temperature_data_t& data) const {
+    const int16_t* __restrict offset = _offset[data.subpage];
+    uint16_t* __restrict pixel       = data.pixel_raw;
+    if (data.stale_rows == 0) {
+        for (uint_fast16_t i = 0; i < pixel_count; ++i) {
+            pixel[i] = add_sat(pixel[i], offset[i]);
+        }
+        return;
+    }
+    // Stale rows hold the previous content, already corrected.
+    for (uint_fast8_t y = 0; y < height; ++y) {
+        if ((data.stale_rows >> y) & 1) continue;
+        const uint_fast16_t end = (y + 1) * row_pixels;
+        for (uint_fast16_t i = y * row_pixels; i < end; ++i) {
+            pixel[i] = add_sat(pixel[i], offset[i]);
+        }
+    }
+}
+
+bool M5_Thermal2_NonUniformity::update(temperature_data_t& data) {
+    const uint_fast8_t sp = data.subpage;
+    bool capturing        = isCapturing();
+    if (capturing) {
+        if (_flat_count[sp] < _flat_target) {
+            uint32_t* sum = _flat_sum[sp];
+            for (uint_fast16_t i = 0; i < pixel_count; ++i) {
+                sum[i] += data.pixel_raw[i];
+            }
+            ++_flat_count[sp];
+        }
+        if (_flat_count[0] >= _flat_target && _flat_count[1] >= _flat_target) {
+            _finishFlatField();
+        }
+    }
+    apply(data);
+    if (_shutterless && !isCapturing()) _learn(data);
+    return !capturing;
+}
+
+void M5_Thermal2_NonUniformity::beginFlatField(uint16_t subpages) {
+    memset(_flat_sum, 0, sizeof(_flat_sum));
+    _flat_count[0] = 0;
+    _flat_count[1] = 0;
+    _flat_target   = subpages ? subpages : 1;
+}
+
+void M5_Thermal2_NonUniformity::_finishFlatField(void) {
+    // Pixel means and their mean, as raw << 8.
+    int64_t total = 0;
+    for (uint_fast8_t sp = 0; sp < 2; ++sp) {
+        for (uint_fast16_t i = 0; i < pixel_count; ++i) {
+            uint32_t mean =
+                ((uint64_t)_flat_sum[sp][i] << 8) / _flat_count[sp];
+            _flat_sum[sp][i] = mean;
+            total += mean;
+        }
+    }
+    int32_t level = total / (int64_t)(pixel_count * 2);
+    for (uint_fast8_t sp = 0; sp < 2; ++sp) {
+        for (uint_fast16_t i = 0; i < pixel_count; ++i) {
+            int32_t e        = level - (int32_t)_flat_sum[sp][i];
+            _estimate[sp][i] = e;
+            _offset[sp][i]   = (e + 128) >> 8;
+        }
+    }
+    memcpy(_reference, _offset, sizeof(_reference));
+    _flat_target = 0;
+    _primed      = 0;
+}
+
+void M5_Thermal2_NonUniformity::_learn(const temperature_data_t& data) {
+    const uint_fast8_t sp = data.subpage;
+    const uint16_t* pixel = data.pixel_raw;
+    const uint32_t stale  = data.stale_rows;
+    uint16_t* prev        = _prev[sp];
+    if (!(_primed & (1 << sp))) {
+        _primed |= 1 << sp;
+        memcpy(prev, pixel, sizeof(_prev[sp]));
+        return;
+    }
+
+    const int32_t limit = (int32_t)_limit_raw << 2;
+    int32_t step[pixel_count];
+    int32_t sum    = 0;
+    uint16_t count = 0;
+    for (uint_fast8_t y = 0; y < height; ++y) {
+        // x of the first pixel of the row in this subpage.
+        const uint_fast8_t x0 = (y & 1) != sp;
+        const int_fast8_t sy  = (y == 0) - (y == height - 1);
+        // Rows the prediction reads: either side, or the two inwards at
+        // the top and bottom. A stale row was not read again: it would look
+        // perfectly static, and it predicts nothing.
+        const uint32_t used      = (sy > 0)   ? 3u << (y + 1)
+                                   : (sy < 0) ? 3u << (y - 2)
+                                              : 5u << (y - 1);
+        const bool stale_row   = (stale >> y) & 1;
+        const bool predictable = !stale_row && !(stale & used);
+        for (uint_fast8_t k = 0; k < row_pixels; ++k) {
+            const uint_fast16_t i = y * row_pixels + k;
+            const int32_t v       = pixel[i];
+            const int32_t motion  = v - prev[i];
+            step[i]               = no_step;
+            if (stale_row) continue;
+            prev[i] = v;
+            if (!predictable) continue;
+            if (motion > _motion_raw || -motion > _motion_raw) continue;
+
+            // Prediction from the diagonal neighbours, the nearest pixels
+            // of the same subpage: their mean. A border pixel has them on
+            // one side only, so the pixel two steps further inwards
+            // extrapolates the mean back to it; a scene gradient would
+            // otherwise be taken for an offset.
+            const uint_fast8_t x = (k << 1) + x0;
+            const int_fast8_t sx = (x == 0) - (x == width - 1);
+            int32_t around       = 0;
+            uint_fast8_t n       = 0;
+            for (int_fast8_t dy = -1; dy <= 1; dy += 2) {
+                if (sy && dy != sy) continue;
+                for (int_fast8_t dx = -1; dx <= 1; dx += 2) {
+                    if (sx && dx != sx) continue;
+                    around += pixel[index_of(x + dx, y + dy)];
+                    ++n;
+                }
+            }
+            int32_t predict = around * (4 / n);  // x 4
+            if (sx || sy) {
+                predict = predict * 2 -
+                          pixel[index_of(x + 2 * sx, y + 2 * sy)] * 4;
+            }
+            int32_t err = predict - (v << 2);
+            if (err > limit || -err > limit) continue;
+            step[i] = (err * 64) >> _rate_shift;  // << 8, / 4
+            sum += step[i];
+            ++count;
+        }
+    }
+    if (count == 0) return;
+
+    // Keep the mean offset: the correction of the level is the unit's.
+    // Each offset also leaks towards the reference table, more slowly than
+    // it learns, so smooth offset fields (which a static scene gradient
+    // also looks like) cannot build up.
+    const int32_t mean       = sum / count;
+    const uint8_t leak       = _rate_shift + leak_shift;
+    const int16_t* reference = _reference[sp];
+    int32_t* estimate        = _estimate[sp];
+    int16_t* offset          = _offset[sp];
+    for (uint_fast16_t i = 0; i < pixel_count; ++i) {
+        if (step[i] == no_step) continue;
+        int32_t e = estimate[i] + step[i] - mean;
+        e -= (e - (int32_t)reference[i] * 256) >> leak;
+        if (e > estimate_max) e = estimate_max;
+        if (e < estimate_min) e = estimate_min;
+        estimate[i] = e;
+        offset[i]   = (e + 128) >> 8;
+    }
+}
+
+void M5_Thermal2_NonUniformity::getTable(table_t& dst) const {
+    memcpy(dst.offset, _offset, sizeof(dst.offset));
+}
+
+void M5_Thermal2_NonUniformity::setTable(const table_t& src) {
+    memcpy(_offset, src.offset, sizeof(_offset));
+    memcpy(_reference, src.offset, sizeof(_reference));
+    for (uint_fast8_t sp = 0; sp < 2; ++sp) {
+        for (uint_fast16_t i = 0; i < pixel_count; ++i) {
+            _estimate[sp][i] = (int32_t)_offset[sp][i] << 8;
+        }
+    }
+}
+
+void M5_Thermal2_NonUniformity::getTable(table8_t& dst) const {
+    int32_t peak = 0;
+    for (uint_fast8_t sp = 0; sp < 2; ++sp) {
+        for (uint_fast16_t i = 0; i < pixel_count; ++i) {
+            int32_t v = _offset[sp][i];
+            if (v < 0) v = -v - 1;  // -128 fits, 128 does not.
+            if (peak < v) peak = v;
+        }
+    }
+    uint8_t shift = 0;
+    while ((peak >> shift) > 127) ++shift;
+    dst.shift = shift;
+    for (uint_fast8_t sp = 0; sp < 2; ++sp) {
+        for (uint_fast16_t i = 0; i < pixel_count; ++i) {
+            int32_t v = _offset[sp][i];
+            if (shift) v = (v + (1 << (shift - 1))) >> shift;  // rounded.
+            dst.offset[sp][i] = (v > 127) ? 127 : v;
+        }
+    }
+}
+
+void M5_Thermal2_NonUniformity::setTable(const table8_t& src) {
+    table_t table;
+    for (uint_fast8_t sp = 0; sp < 2; ++sp) {
+        for (uint_fast16_t i = 0; i < pixel_count; ++i) {
+            table.offset[sp][i] = (int32_t)src.offset[sp][i] << src.shift;
+        }
+    }
+    setTable(table);
+}
@@ -0,0 +1,122 @@
+/*!
+ * @brief Per-pixel offset (non-uniformity) correction for Unit Thermal2.
+ * @copyright Copyright (c) 2022 by M5Stack[https://m5stack.com]
+ *
+ * Removes the residual fixed pattern of the sensor on the host, so the unit's
+ * noise filter (setNoiseFilterLevel) need not be raised to hide it. Each
+ * subpage parity has its own table of 384 int16 offsets (raw units), and
+ * correcting a subpage costs one saturating add per pixel.
+ *
+ * The table comes from either or both of:
+ *   - a flat field: the mean of a number of subpages of a uniform scene
+ *     (lens cap, wall), each pixel offset to the mean of all pixels.
+ *   - the shutterless estimator: after each corrected subpage, a pixel that
+ *     is static (changed by at most motion_raw since the previous subpage of
+ *     its parity) and differs from the mean of its diagonal neighbours (same
+ *     subpage; extrapolated at the border) by at most limit_raw has its
+ *     offset moved by 1/2^rate_shift of that difference. Larger differences
+ *     are scene detail and are left alone. The mean of each update is
+ *     removed, so the absolute level of the unit is kept, and the offsets
+ *     leak 16 times more slowly back to the flat field table, so smooth
+ *     offset fields (a static scene gradient looks the same) cannot build
+ *     up. Detail below limit_raw that stays in place for many time constants
+ *     is partly flattened as well.
+ *
+ * Tables can be saved as table_t (int16, 1536 bytes) or table8_t (int8 with
+ * a common shift, 769 bytes) and restored, e.g. from flash. Correct the
+ * subpage before M5_Thermal2_TemporalFilter::filter() and
+ * M5_Thermal2_FrameAssembler::merge(). temperature_reg keeps the unit's
+ * overview of the uncorrected subpage.
+ */
+#ifndef _M5_THERMAL2_NONUNIFORMITY_H_
+#define _M5_THERMAL2_NONUNIFORMITY_H_
+
+#include "M5_Thermal2.h"
+
+class M5_Thermal2_NonUniformity {
+   public:
+    typedef M5_Thermal2::temperature_data_t temperature_data_t;
+
+    static constexpr size_t pixel_count = M5_Thermal2::subpage_pixels;
+
+    /// Offsets per subpage and pixel. (raw, added to pixel_raw)
+    struct table_t {
+        int16_t offset[2][pixel_count];
+    };
+    /// Compact table: offset = value << shift.
+    struct table8_t {
+        uint8_t shift;
+        int8_t offset[2][pixel_count];
+    };
+
+    M5_Thermal2_NonUniformity(void);
+
+    /*! @brief Correct a subpage in place. (one add per pixel, saturated
+     * to 0~65535) */
+    void apply(temperature_data_t& data) const;
+
+    /*! @brief Feed a subpage: flat field capture (if started), apply(), then
+               the shutterless estimator (if enabled).
+        @return true:corrected / false:the flat field capture took this
+                subpage, it was corrected with the previous table */
+    bool update(temperature_data_t& data);
+
+    /*! @brief Start a flat field capture. Point the unit at a uniform scene
+               and feed update() until isCapturing() returns false.
+        @param subpages to average per parity, 1 or more (default 64) */
+    void beginFlatField(uint16_t subpages = 64);
+    inline bool isCapturing(void) const {
+        return _flat_target != 0;
+    }
+
+    /*! @brief Enable the shutterless estimator. (disabled by default) */
+    inline void setShutterless(bool enable) {
+        _shutterless = enable;
+        _primed      = 0;
+    }
+    inline bool getShutterless(void) const {
+        return _shutterless;
+    }
+    /*! @brief Set the estimator response.
+        @param rate_shift 1 ~ 15. Time constant, in subpages of a parity.
+                          (default 7: 128, 8 s at 32 Hz)
+        @param limit_raw Largest difference to the neighbours corrected.
+        @param motion_raw Largest change since the previous subpage for a
+                          pixel to count as static. */
+    void setEstimatorParam(uint8_t rate_shift = 7, uint16_t limit_raw = 96,
+                           uint16_t motion_raw = 64);
+
+    inline int16_t getOffset(uint_fast8_t subpage,
+                             uint_fast16_t index) const {
+        return _offset[subpage & 1][index];
+    }
+
+    void getTable(table_t& dst) const;
+    void setTable(const table_t& src);
+    /*! @brief Save as int8, with the smallest shift that keeps every offset
+               in range. Offsets lose their low shift bits. */
+    void getTable(table8_t& dst) const;
+    void setTable(const table8_t& src);
+
+    /*! @brief Zero all offsets, stop a flat field capture. */
+    void clear(void);
+
+   private:
+    int16_t _offset[2][pixel_count];
+    int16_t _reference[2][pixel_count];  // flat field, or setTable().
+    int32_t _estimate[2][pixel_count];   // offset << 8, estimator state.
+    uint16_t _prev[2][pixel_count];      // previous corrected subpage.
+    uint32_t _flat_sum[2][pixel_count];
+    uint16_t _flat_count[2] = {0, 0};
+    uint16_t _flat_target   = 0;
+    uint16_t _limit_raw     = 96;
+    uint16_t _motion_raw    = 64;
+    uint8_t _rate_shift     = 7;
+    uint8_t _primed         = 0;  // bit per subpage
+    bool _shutterless       = false;
+
+    void _finishFlatField(void);
+    void _learn(const temperature_data_t& data);
+};
+
+#endif
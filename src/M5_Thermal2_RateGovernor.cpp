@@ -0,0 +1,107 @@
+#include "M5_Thermal2_RateGovernor.h"
+
+// Slowest rate up to active whose subpage period is within msec.
+static uint8_t lowest_rate(uint8_t active, uint32_t msec) {
+    uint8_t rate = 0;
+    while (rate < active && (2000000u >> rate) > (uint64_t)msec * 1000) {
+        ++rate;
+    }
+    return rate;
+}
+
+bool M5_Thermal2_RateGovernor::begin(M5_Thermal2* unit,
+                                     M5_Thermal2_ClockGovernor* clock) {
+    if (unit == nullptr) return false;
+    _unit   = unit;
+    _clock  = clock;
+    _rate   = unit->getRefreshRate();
+    _active = _rate;
+    _lowest = lowest_rate(_active, _latency_msec);
+    resetStats();
+    _decisions   = 0;
+    _quiet_since = millis();
+    return _apply(_active, reason_start, 0);
+}
+
+bool M5_Thermal2_RateGovernor::update(const temperature_data_t& data,
+                                      bool host_activity) {
+    if (_unit == nullptr) return false;
+    _account();
+    ++_frames[_rate];
+
+    uint32_t now       = millis();
+    uint16_t most_diff = data.temperature_reg.most_diff_raw;
+    if (host_activity || most_diff >= _activity_raw) {
+        _quiet_since = now;
+        if (_rate == _active) return false;
+        return _apply(_active, reason_activity, most_diff);
+    }
+    if (most_diff >= _quiet_raw) {
+        // Between the thresholds: neither active nor quiet.
+        _quiet_since = now;
+        return false;
+    }
+    if (_rate <= _lowest || now - _quiet_since < _quiet_msec) return false;
+    _quiet_since = now;  // each step down takes a full quiet period.
+    return _apply(_rate - 1, reason_quiet, most_diff);
+}
+
+void M5_Thermal2_RateGovernor::setThreshold(uint16_t activity_raw,
+                                            uint16_t quiet_raw) {
+    if (quiet_raw > activity_raw) quiet_raw = activity_raw;
+    _activity_raw = activity_raw;
+    _quiet_raw    = quiet_raw;
+}
+
+void M5_Thermal2_RateGovernor::setMaxLatency(uint32_t msec) {
+    _latency_msec = msec;
+    _lowest       = lowest_rate(_active, msec);
+    if (_unit && _rate < _lowest) _apply(_lowest, reason_start, 0);
+}
+
+void M5_Thermal2_RateGovernor::setActiveRate(refresh_rate_t rate) {
+    _active = rate & 7;
+    _lowest = lowest_rate(_active, _latency_msec);
+    if (_unit && _rate != _active) _apply(_active, reason_start, 0);
+}
+
+uint64_t M5_Thermal2_RateGovernor::getMicrosAtRate(refresh_rate_t rate) const {
+    uint64_t usec = _usec[rate & 7];
+    if (_unit && (rate & 7) == _rate) usec += micros() - _since_usec;
+    return usec;
+}
+
+void M5_Thermal2_RateGovernor::resetStats(void) {
+    memset(_usec, 0, sizeof(_usec));
+    memset(_frames, 0, sizeof(_frames));
+    _since_usec = micros();
+}
+
+const M5_Thermal2_RateGovernor::decision_t*
+M5_Thermal2_RateGovernor::getHistory(size_t index) const {
+    if (index >= getHistoryCount()) return nullptr;
+    return &_history[(_decisions - 1 - index) % history_size];
+}
+
+bool M5_Thermal2_RateGovernor::_apply(uint8_t rate, uint8_t reason,
+                                      uint16_t most_diff_raw) {
+    // On failure the rate is kept, and tried again by a later decision.
+    if (!_unit->setRefreshRate((refresh_rate_t)rate)) return false;
+    _account();
+    _rate = rate;
+    if (_clock) _clock->retune();
+
+    auto& d         = _history[_decisions++ % history_size];
+    d.msec          = millis();
+    d.most_diff_raw = most_diff_raw;
+    d.rate          = rate;
+    d.reason        = reason;
+    return true;
+}
+
+void M5_Thermal2_RateGovernor::_account(void) {
+    // Called at least once per subpage, so micros() cannot wrap in between.
+    uint32_t now = micros();
+    _usec[_rate] += now - _since_usec;
+    _since_usec = now;
+}
@@ -0,0 +1,135 @@
+/*!
+ * @brief Scene-adaptive refresh rate for Unit Thermal2.
+ * @copyright Copyright (c) 2022 by M5Stack[https://m5stack.com]
+ *
+ * Runs the unit at its active refresh rate while the scene changes and steps
+ * the rate down, one halving per quiet period, while it does not. Activity is
+ * the overview's most_diff_raw (the largest pixel change the unit saw inside
+ * its monitor area) or a host metric passed to update(), e.g. the motion
+ * score of M5_Thermal2_BackgroundModel. Two thresholds give hysteresis:
+ *   - most_diff_raw >= activity_raw, or host activity: back to the active
+ *     rate at once, with the subpage that showed it.
+ *   - most_diff_raw <  quiet_raw for quiet_msec: one rate lower.
+ *   - in between: stay, and restart the quiet period.
+ * The lowest rate is the slowest one whose subpage period is within the
+ * latency bound, so activity is seen at most that long after it starts (plus
+ * the read of that subpage). Time and subpages are counted per rate.
+ *
+ * With profile_pixels_only the overview is not read: pass host activity.
+ * Changing the rate writes the unit's config, so call update() between
+ * updates, not while a non-blocking update is in progress. The unit's ready
+ * predictor restarts from the nominal period of every new rate by itself; a
+ * M5_Thermal2_ClockGovernor given to begin() is retuned for it.
+ */
+#ifndef _M5_THERMAL2_RATEGOVERNOR_H_
+#define _M5_THERMAL2_RATEGOVERNOR_H_
+
+#include "M5_Thermal2.h"
+#include "M5_Thermal2_ClockGovernor.h"
+
+class M5_Thermal2_RateGovernor {
+   public:
+    typedef M5_Thermal2::temperature_data_t temperature_data_t;
+    typedef M5_Thermal2::refresh_rate_t refresh_rate_t;
+
+    enum reason_t : uint8_t {
+        reason_start,     // Initial rate, or set by the application.
+        reason_activity,  // Activity seen, back to the active rate.
+        reason_quiet,     // Quiet period, stepped down.
+    };
+
+    /// One rate change.
+    struct decision_t {
+        uint32_t msec;           // millis() at the decision.
+        uint16_t most_diff_raw;  // of the subpage that caused it.
+        uint8_t rate;            // New refresh rate. (refresh_rate_t)
+        uint8_t reason;          // reason_t
+    };
+
+    static constexpr size_t history_size = 16;
+    static constexpr size_t rate_count   = 8;
+
+    /*! @brief Attach to a unit. Its current refresh rate becomes the active
+               rate.
+        @param unit Unit whose refresh rate is governed.
+        @param clock Pixel read clock governor of the same unit, retuned
+                     after every rate change. (optional)
+        @return true:success / false:failure */
+    bool begin(M5_Thermal2* unit, M5_Thermal2_ClockGovernor* clock = nullptr);
+
+    /*! @brief Feed a new subpage.
+        @param data Subpage returned by M5_Thermal2::update().
+        @param host_activity Activity found by the host, e.g.
+                             getMotionScore() != 0.
+        @return true: the refresh rate was changed */
+    bool update(const temperature_data_t& data, bool host_activity = false);
+
+    /*! @brief Set the activity thresholds of most_diff_raw.
+        @param activity_raw back to the active rate at or above (default 128)
+        @param quiet_raw quiet below, at most activity_raw (default 64) */
+    void setThreshold(uint16_t activity_raw = 128, uint16_t quiet_raw = 64);
+
+    /*! @brief Quiet time before each step down. (default 2000 msec) */
+    inline void setQuietTime(uint32_t msec) {
+        _quiet_msec = msec;
+    }
+
+    /*! @brief Longest subpage period allowed, i.e. the worst delay before
+               activity is seen. (default 500 msec: 2Hz at the lowest) */
+    void setMaxLatency(uint32_t msec);
+
+    /*! @brief Set the rate used while the scene is active. */
+    void setActiveRate(refresh_rate_t rate);
+    inline refresh_rate_t getActiveRate(void) const {
+        return (refresh_rate_t)_active;
+    }
+    /*! @brief Lowest rate allowed by the latency bound. */
+    inline refresh_rate_t getLowestRate(void) const {
+        return (refresh_rate_t)_lowest;
+    }
+    /*! @brief Current refresh rate. */
+    inline refresh_rate_t getRate(void) const {
+        return (refresh_rate_t)_rate;
+    }
+
+    /*! @brief Time spent at a rate since begin() / resetStats(). (usec) */
+    uint64_t getMicrosAtRate(refresh_rate_t rate) const;
+    /*! @brief Subpages fed at a rate since begin() / resetStats(). */
+    inline uint32_t getFramesAtRate(refresh_rate_t rate) const {
+        return _frames[rate & 7];
+    }
+    void resetStats(void);
+
+    /*! @brief Number of stored decisions. (up to history_size) */
+    inline size_t getHistoryCount(void) const {
+        return (_decisions < history_size) ? _decisions : history_size;
+    }
+
+    /*! @brief Get a past decision.
+        @param index 0 = newest
+        @return decision / nullptr:out of range */
+    const decision_t* getHistory(size_t index) const;
+
+   private:
+    bool _apply(uint8_t rate, uint8_t reason, uint16_t most_diff_raw);
+    void _account(void);
+
+    M5_Thermal2* _unit                = nullptr;
+    M5_Thermal2_ClockGovernor* _clock = nullptr;
+    uint8_t _rate                     = 0;
+    uint8_t _active                   = 0;
+    uint8_t _lowest                   = 0;
+    uint16_t _activity_raw            = 128;
+    uint16_t _quiet_raw               = 64;
+    uint32_t _quiet_msec              = 2000;
+    uint32_t _latency_msec            = 500;
+
+    uint32_t _quiet_since = 0;  // millis()
+    uint32_t _since_usec  = 0;  // micros() of the last accounting.
+    uint64_t _usec[rate_count];
+    uint32_t _frames[rate_count];
+    uint32_t _decisions = 0;
+    decision_t _history[history_size];
+};
+
+#endif
@@ -0,0 +1,180 @@
+#include "M5_Thermal2_Renderer.h"
+
+#include <stdlib.h>
+
+static constexpr int_fast8_t frame_width  = M5_Thermal2::frame_width;
+static constexpr int_fast8_t frame_height = M5_Thermal2::frame_height;
+
+// Column values are clamped to +-32 colour map lengths, so the difference of
+// two of them and a step of the index still fit into int32_t. (16.16)
+static constexpr int32_t column_limit = 1 << 29;
+static constexpr int32_t index_end    = 256 << 16;
+
+M5_Thermal2_Renderer::~M5_Thermal2_Renderer(void) {
+    free(_row);
+}
+
+bool M5_Thermal2_Renderer::setSize(uint16_t width, uint16_t height) {
+    if (width == 0 || height == 0) return false;
+    if (_width != width) {
+        auto row = (uint16_t*)realloc(_row, width * sizeof(uint16_t));
+        if (row == nullptr) return false;
+        _row = row;
+    }
+    _width  = width;
+    _height = height;
+    _step_x = (width > 1) ? ((frame_width - 1) << 16) / (width - 1) : 0;
+    _step_y = (height > 1) ? ((frame_height - 1) << 16) / (height - 1) : 0;
+    // Pixels per source column, plus one for the rounding of the start.
+    _span_margin = (_step_x ? (65535 + _step_x) / _step_x : width) + 1;
+
+    uint32_t u      = 0;
+    uint_fast16_t x = 0;
+    for (int_fast8_t fx = 0; fx < frame_width - 1; ++fx) {
+        _span_frac[fx] = u - (fx << 16);
+        if (fx == frame_width - 2) {
+            x = width;
+        } else {
+            for (; x < width && u < (uint32_t)(fx + 1) << 16; ++x) {
+                u += _step_x;
+            }
+        }
+        _span_end[fx] = x;
+    }
+    return true;
+}
+
+void M5_Thermal2_Renderer::setColorMap(const uint16_t* table) {
+    _table = table;
+    _updateLut();
+}
+
+void M5_Thermal2_Renderer::setSwap565(bool swap) {
+    _swap565 = swap;
+    _updateLut();
+}
+
+void M5_Thermal2_Renderer::setRange(int32_t raw_lowest, int32_t raw_highest) {
+    int32_t diff = raw_highest - raw_lowest + 1;
+    if (diff < 1) diff = 1;
+    _raw_low   = raw_lowest;
+    _index_mul = (256 << 16) / diff;
+}
+
+void M5_Thermal2_Renderer::_updateLut(void) {
+    if (_table == nullptr) return;
+    for (size_t i = 0; i < M5_Thermal2_ColorMap::table_size; ++i) {
+        uint16_t c = _table[i];
+        _lut[i]    = _swap565 ? (uint16_t)(c << 8 | c >> 8) : c;
+    }
+}
+
+bool M5_Thermal2_Renderer::render(const uint16_t* frame,
+                                  row_callback_t callback, void* user) {
+    if (_row == nullptr || _table == nullptr || callback == nullptr) {
+        return false;
+    }
+    uint32_t v = 0;
+    for (uint_fast16_t y = 0; y < _height; ++y, v += _step_y) {
+        _renderSpans(frame, v, 0, frame_width - 1);
+        callback(user, y, _row, _width);
+    }
+    return true;
+}
+
+bool M5_Thermal2_Renderer::render(const uint16_t* frame, uint64_t change_map,
+                                  span_callback_t callback, void* user) {
+    if (_row == nullptr || _table == nullptr || callback == nullptr) {
+        return false;
+    }
+    uint32_t v = 0;
+    for (uint_fast16_t y = 0; y < _height; ++y, v += _step_y) {
+        // Tiles of the two source rows this output row blends.
+        int_fast8_t fy = v >> 16;
+        if (fy >= frame_height - 1) fy = frame_height - 2;
+        uint32_t tiles = (uint32_t)(change_map >> ((fy >> 2) << 3)) |
+                         (uint32_t)(change_map >> (((fy + 1) >> 2) << 3));
+        tiles &= 0xFF;
+        if (tiles == 0) continue;
+
+        // Source columns of the changed tiles, then the spans (fx, fx+1)
+        // that read one of them.
+        uint32_t columns = 0;
+        for (uint_fast8_t t = 0; t < 8; ++t) {
+            if (tiles & (1u << t)) columns |= 0xFu << (t << 2);
+        }
+        uint32_t spans = (columns | (columns >> 1)) & 0x7FFFFFFFu;
+        while (spans) {
+            int_fast8_t begin = __builtin_ctz(spans);
+            int_fast8_t end   = begin;
+            while (end < frame_width - 1 && (spans & (1u << end))) ++end;
+            spans &= ~0u << end;
+
+            uint16_t x0 = begin ? _span_end[begin - 1] : 0;
+            uint16_t x1 = _span_end[end - 1];
+            if (x0 == x1) continue;
+            _renderSpans(frame, v, begin, end);
+            callback(user, y, x0, &_row[x0], x1 - x0);
+        }
+    }
+    return true;
+}
+
+void M5_Thermal2_Renderer::_renderSpans(const uint16_t* frame, uint32_t v,
+                                        int_fast8_t fx_begin,
+                                        int_fast8_t fx_end) {
+    const uint16_t* __restrict lut = _lut;
+    uint16_t* __restrict row       = _row;
+    int32_t column[frame_width];
+
+    // Vertical pass: one colour index per source column. (16.16)
+    int_fast8_t fy = v >> 16;
+    int32_t wy     = v & 0xFFFF;
+    if (fy >= frame_height - 1) {
+        fy = frame_height - 2;
+        wy = 1 << 16;
+    }
+    const uint16_t* src0 = &frame[fy * frame_width];
+    const uint16_t* src1 = src0 + frame_width;
+    for (int_fast8_t fx = fx_begin; fx <= fx_end; ++fx) {
+        int64_t r  = ((int64_t)(src0[fx] - _raw_low) << 16) +
+                    (int64_t)(src1[fx] - src0[fx]) * wy;
+        int64_t c  = (r * _index_mul) >> 16;
+        column[fx] = (c < -column_limit)  ? -column_limit
+                     : (c > column_limit) ? column_limit
+                                          : (int32_t)c;
+    }
+
+    // Horizontal pass: the index changes by a constant step within a
+    // source column span.
+    uint_fast16_t x = fx_begin ? _span_end[fx_begin - 1] : 0;
+    for (int_fast8_t fx = fx_begin; fx < fx_end; ++fx) {
+        uint_fast16_t x_end = _span_end[fx];
+        if (x == x_end) continue;
+        int32_t c0   = column[fx];
+        int32_t c1   = column[fx + 1];
+        int64_t d    = c1 - c0;
+        int64_t step = (d * _step_x) >> 16;
+        int32_t i    = c0 + (int32_t)((d * _span_frac[fx]) >> 16);
+        // Limited only when shrinking, where the span has one pixel.
+        int32_t di = (step < -2 * column_limit)  ? -2 * column_limit
+                     : (step > 2 * column_limit) ? 2 * column_limit
+                                                 : (int32_t)step;
+
+        // The stepped index drifts below the exact one by at most one
+        // per pixel, so a span away from both ends needs no clamp.
+        int32_t lo = (c0 < c1) ? c0 : c1;
+        int32_t hi = (c0 < c1) ? c1 : c0;
+        if (lo >= _span_margin && hi < index_end) {
+            for (; x < x_end; ++x, i += di) {
+                row[x] = lut[i >> 16];
+            }
+        } else {
+            for (; x < x_end; ++x, i += di) {
+                row[x] = lut[(i < 0)            ? 0
+                             : (i >= index_end) ? 255
+                                                : (i >> 16)];
+            }
+        }
+    }
+}
@@ -0,0 +1,112 @@
+/*!
+ * @brief Bilinear upscaler and colour mapper for Unit Thermal2 frames.
+ * @copyright Copyright (c) 2022 by M5Stack[https://m5stack.com]
+ *
+ * Scales an assembled 32x24 frame to any output size and hands the result
+ * over one RGB565 row at a time, so no full framebuffer is needed. The frame
+ * corners map to the output corners. All per-pixel work is additions and a
+ * table lookup; divisions happen only when the size or range is set.
+ *
+ * Accuracy: the colour index is within 1 of an exact bilinear interpolation
+ * at the same positions (16.16 rounding, see extras/host bench_renderer).
+ * The SmoothDraw code this replaced spread each source interval over a whole
+ * number of output pixels, so it sampled up to one output pixel away from
+ * these positions: next to a steep edge such as a hot spot the two differ
+ * by the index change across one output pixel. (on the simulator scene up
+ * to 26 at 320x240 and 48 at 128x96, 0.3 ~ 0.8 on average)
+ */
+#ifndef _M5_THERMAL2_RENDERER_H_
+#define _M5_THERMAL2_RENDERER_H_
+
+#include "M5_Thermal2.h"
+#include "M5_Thermal2_ColorMap.h"
+
+class M5_Thermal2_Renderer {
+   public:
+    /*! @brief Receives one rendered row.
+        @param user Pointer passed to render().
+        @param y Output row. (0 ~ height-1, in order)
+        @param row width colours. Valid only during the call. */
+    typedef void (*row_callback_t)(void* user, uint16_t y, const uint16_t* row,
+                                   uint16_t width);
+
+    /*! @brief Receives part of one rendered row.
+        @param x First output column of the part.
+        @param row width colours from column x. Valid only during the call.
+     */
+    typedef void (*span_callback_t)(void* user, uint16_t y, uint16_t x,
+                                    const uint16_t* row, uint16_t width);
+
+    M5_Thermal2_Renderer(void) = default;
+    M5_Thermal2_Renderer(const M5_Thermal2_Renderer&) = delete;
+    M5_Thermal2_Renderer& operator=(const M5_Thermal2_Renderer&) = delete;
+    ~M5_Thermal2_Renderer(void);
+
+    /*! @brief Set the output size. Allocates one row. (width * 2 bytes)
+        @return true:success / false:failure */
+    bool setSize(uint16_t width, uint16_t height);
+
+    /*! @brief Set the colour map. (256 RGB565 entries, copied) */
+    void setColorMap(const uint16_t* table);
+    inline void setColorMap(M5_Thermal2_ColorMap::color_map_t map) {
+        setColorMap(M5_Thermal2_ColorMap::getTable(map));
+    }
+
+    /*! @brief Emit byte-swapped RGB565, as most SPI panels expect. */
+    void setSwap565(bool swap);
+
+    /*! @brief Set the raw value range mapped onto the colour map.
+        @param raw_lowest Raw value drawn with colour 0.
+        @param raw_highest Raw value drawn with colour 255. */
+    void setRange(int32_t raw_lowest, int32_t raw_highest);
+
+    /*! @brief Render a frame.
+        @param frame 32x24 row major raw values. (frame_data_t::pixel_raw)
+        @param callback Called once per output row, top to bottom.
+        @param user Passed to callback.
+        @return true:success / false:size or colour map not set */
+    bool render(const uint16_t* frame, row_callback_t callback,
+                void* user = nullptr);
+
+    /*! @brief Render only the output pixels that depend on changed tiles.
+        @param change_map Bit (tx + ty * 8) per 4x4 source tile, as
+               M5_Thermal2_FrameAssembler::getChangeMap() gives.
+        @param callback Called for each run of affected pixels, top to
+               bottom and left to right within a row. Rows without one
+               are skipped.
+        @brief Pass ~0 after the size, range or colour map changed. */
+    bool render(const uint16_t* frame, uint64_t change_map,
+                span_callback_t callback, void* user = nullptr);
+
+    inline uint16_t width(void) const {
+        return _width;
+    }
+    inline uint16_t height(void) const {
+        return _height;
+    }
+
+   private:
+    void _updateLut(void);
+    void _renderSpans(const uint16_t* frame, uint32_t v, int_fast8_t fx_begin,
+                      int_fast8_t fx_end);
+
+    uint16_t* _row       = nullptr;
+    uint16_t _width      = 0;
+    uint16_t _height     = 0;
+    uint32_t _step_x     = 0;  // source x per output pixel. (16.16)
+    uint32_t _step_y     = 0;  // source y per output row. (16.16)
+    int32_t _span_margin = 0;  // worst rounding drift within one span.
+    int32_t _raw_low     = 0;
+    int32_t _index_mul   = 0;  // colour index per raw value. (16.16)
+    bool _swap565        = false;
+
+    const uint16_t* _table = nullptr;
+    uint16_t _lut[M5_Thermal2_ColorMap::table_size];
+
+    // Output x where each source column span ends, and the source x
+    // fraction of its first pixel. (16.16)
+    uint16_t _span_end[M5_Thermal2::frame_width - 1];
+    uint32_t _span_frac[M5_Thermal2::frame_width - 1];
+};
+
+#endif
@@ -0,0 +1,104 @@
+#include "M5_Thermal2_RoiEngine.h"
+
+#include <string.h>
+
+static constexpr int_fast8_t sat_stride = M5_Thermal2::frame_width + 1;
+
+M5_Thermal2_RoiEngine::M5_Thermal2_RoiEngine(void) {
+    // The first row and column stay zero.
+    memset(_sat, 0, sizeof(_sat));
+}
+
+void M5_Thermal2_RoiEngine::update(const uint16_t* frame, bool minmax) {
+    for (uint_fast8_t y = 0; y < height; ++y) {
+        const uint16_t* src = &frame[y * width];
+        const uint32_t* up  = &_sat[y * sat_stride + 1];
+        uint32_t* dst       = &_sat[(y + 1) * sat_stride + 1];
+        uint32_t row_sum    = 0;
+        for (uint_fast8_t x = 0; x < width; ++x) {
+            row_sum += src[x];
+            dst[x] = up[x] + row_sum;
+        }
+    }
+    _minmax = minmax;
+    _frame  = frame;
+    if (!minmax) return;
+
+    // Each level combines two runs of the level below. (the frame for 0)
+    for (uint_fast8_t k = 0; k < levels; ++k) {
+        const uint_fast8_t half = 1u << k;
+        const uint_fast8_t end  = width - (half << 1) + 1;
+        for (uint_fast8_t y = 0; y < height; ++y) {
+            const uint16_t* lo = k ? _lowest[k - 1][y] : &frame[y * width];
+            const uint16_t* hi = k ? _highest[k - 1][y] : &frame[y * width];
+            uint16_t* lo_dst   = _lowest[k][y];
+            uint16_t* hi_dst   = _highest[k][y];
+            for (uint_fast8_t x = 0; x < end; ++x) {
+                uint16_t a = lo[x];
+                uint16_t b = lo[x + half];
+                lo_dst[x]  = (a < b) ? a : b;
+                a          = hi[x];
+                b          = hi[x + half];
+                hi_dst[x]  = (a > b) ? a : b;
+            }
+        }
+    }
+}
+
+bool M5_Thermal2_RoiEngine::query(int x, int y, int w, int h,
+                                  roi_stats_t& dst) const {
+    int x0 = (x < 0) ? 0 : x;
+    int y0 = (y < 0) ? 0 : y;
+    int x1 = (x + w > width) ? width : x + w;
+    int y1 = (y + h > height) ? height : y + h;
+    if (_frame == nullptr || x0 >= x1 || y0 >= y1) {
+        memset(&dst, 0, sizeof(dst));
+        return false;
+    }
+    dst.sum = _sat[y1 * sat_stride + x1] - _sat[y0 * sat_stride + x1] -
+              _sat[y1 * sat_stride + x0] + _sat[y0 * sat_stride + x0];
+    dst.count   = (x1 - x0) * (y1 - y0);
+    dst.average = dst.sum / dst.count;
+    if (!_minmax) {
+        dst.lowest  = 0;
+        dst.highest = 0;
+        return true;
+    }
+
+    // Lowest and highest have no inverse: per row, the two runs of the
+    // largest size within the span, one from each end, cover it.
+    uint16_t lowest  = 65535;
+    uint16_t highest = 0;
+    const int span   = x1 - x0;
+    if (span == 1) {
+        for (int yy = y0; yy < y1; ++yy) {
+            uint16_t v = _frame[yy * width + x0];
+            lowest     = (lowest < v) ? lowest : v;
+            highest    = (highest > v) ? highest : v;
+        }
+    } else {
+        int k = 0;
+        while ((4 << k) <= span) ++k;
+        const int x2 = x1 - (2 << k);
+        for (int yy = y0; yy < y1; ++yy) {
+            const uint16_t* lo = _lowest[k][yy];
+            const uint16_t* hi = _highest[k][yy];
+            uint16_t a         = (lo[x0] < lo[x2]) ? lo[x0] : lo[x2];
+            uint16_t b         = (hi[x0] > hi[x2]) ? hi[x0] : hi[x2];
+            lowest             = (lowest < a) ? lowest : a;
+            highest            = (highest > b) ? highest : b;
+        }
+    }
+    dst.lowest  = lowest;
+    dst.highest = highest;
+    return true;
+}
+
+size_t M5_Thermal2_RoiEngine::query(const roi_t* rois, size_t count,
+                                    roi_stats_t* dst) const {
+    size_t result = 0;
+    for (size_t i = 0; i < count; ++i) {
+        result += query(rois[i], dst[i]) ? 1 : 0;
+    }
+    return result;
+}
@@ -0,0 +1,124 @@
+#include "M5_Thermal2_Scheduler.h"
+
+int M5_Thermal2_Scheduler::addUnit(M5_Thermal2* unit) {
+    if (unit == nullptr || unit->getWire() == nullptr) return -1;
+    if (_unit_count >= unit_max) return -1;
+    for (uint_fast8_t i = 0; i < _unit_count; ++i) {
+        if (_unit[i].unit == unit) return -1;
+    }
+
+    uint_fast8_t b = 0;
+    while (b < _bus_count && _bus[b].wire != unit->getWire()) ++b;
+    if (b == _bus_count) {
+        _bus[b] = {unit->getWire(), 0};
+        ++_bus_count;
+    }
+    uint8_t id = _unit_count++;
+    _unit[id]  = {unit, unit->getWire(), micros(), {}};
+    if (_unit_count == 1) _stats_start_usec = micros();
+    return id;
+}
+
+uint8_t M5_Thermal2_Scheduler::update(void) {
+    uint8_t delivered = 0;
+    for (uint_fast8_t b = 0; b < _bus_count; ++b) {
+        bus_t& bus   = _bus[b];
+        uint32_t now = micros();
+
+        // Round robin over the units updating or due, starting after the
+        // one that had the last turn: a slow or restarting unit gets one
+        // transaction per turn like the others.
+        unit_t* u = nullptr;
+        for (uint_fast8_t n = 1; n <= _unit_count; ++n) {
+            uint_fast8_t i = (bus.turn + n) % _unit_count;
+            unit_t& c      = _unit[i];
+            if (c.wire != bus.wire) continue;
+            if (c.unit->isUpdating() || (int32_t)(now - c.due_usec) >= 0) {
+                u        = &c;
+                bus.turn = i;
+                break;
+            }
+        }
+        if (u == nullptr) continue;
+        if (!u->unit->isUpdating()) u->unit->beginUpdate();
+
+        auto state = u->unit->poll();
+        uint32_t t = micros();
+        u->stats.busy_usec += t - now;
+        _schedule(*u, state, t);
+        if (state == M5_Thermal2::update_done) {
+            ++delivered;
+            if (_callback) {
+                _callback(_user, u - _unit, t, u->unit->getTemperatureData());
+            }
+        }
+    }
+    return delivered;
+}
+
+void M5_Thermal2_Scheduler::_schedule(unit_t& u,
+                                      M5_Thermal2::update_state_t state,
+                                      uint32_t now) {
+    uint32_t interval = u.unit->getPollIntervalMicros();
+    switch (state) {
+        default:
+            break;
+        case M5_Thermal2::update_done:
+            ++u.stats.frames;
+            u.due_usec = u.unit->nextFrameDueMicros() - interval;
+            break;
+        case M5_Thermal2::update_failed:
+            if (u.unit->getLastFailure() == M5_Thermal2::failure_not_ready) {
+                ++u.stats.not_ready;
+            } else {
+                ++u.stats.failures;
+            }
+            u.due_usec = now + interval;
+            break;
+    }
+}
+
+uint32_t M5_Thermal2_Scheduler::getIdleMicros(void) const {
+    uint32_t now    = micros();
+    uint32_t result = UINT32_MAX;
+    for (uint_fast8_t i = 0; i < _unit_count; ++i) {
+        if (_unit[i].unit->isUpdating()) return 0;
+        int32_t wait = _unit[i].due_usec - now;
+        if (wait <= 0) return 0;
+        if (result > (uint32_t)wait) result = wait;
+    }
+    return (_unit_count) ? result : 0;
+}
+
+float M5_Thermal2_Scheduler::getUnitFps(uint8_t unit_id) const {
+    uint32_t elapsed = micros() - _stats_start_usec;
+    if (unit_id >= _unit_count || elapsed == 0) return 0.0f;
+    return _unit[unit_id].stats.frames * 1000000.0f / elapsed;
+}
+
+float M5_Thermal2_Scheduler::getTotalFps(void) const {
+    float result = 0.0f;
+    for (uint_fast8_t i = 0; i < _unit_count; ++i) {
+        result += getUnitFps(i);
+    }
+    return result;
+}
+
+float M5_Thermal2_Scheduler::getBusUtilization(const TwoWire* wire) const {
+    uint32_t elapsed = micros() - _stats_start_usec;
+    if (elapsed == 0) return 0.0f;
+    uint64_t busy = 0;
+    for (uint_fast8_t i = 0; i < _unit_count; ++i) {
+        if (wire == nullptr || _unit[i].wire == wire) {
+            busy += _unit[i].stats.busy_usec;
+        }
+    }
+    return (float)busy / elapsed;
+}
+
+void M5_Thermal2_Scheduler::resetStats(void) {
+    for (uint_fast8_t i = 0; i < _unit_count; ++i) {
+        _unit[i].stats = {};
+    }
+    _stats_start_usec = micros();
+}
@@ -0,0 +1,102 @@
+/*!
+ * @brief Acquisition scheduler for several Unit Thermal2 on one or more buses.
+ * @copyright Copyright (c) 2022 by M5Stack[https://m5stack.com]
+ *
+ * Drives the units through beginUpdate() / poll(). A unit is started only
+ * when its next subpage is due (M5_Thermal2::nextFrameDueMicros()), so the
+ * bus is not spent on not-ready polls.
+ * Units updating on the same bus take turns one transaction at a time, round
+ * robin, so neither a unit's pixel chunks nor a slow or restarting unit hold
+ * the bus from the others. Units on different buses advance in the same
+ * update() call.
+ */
+#ifndef _M5_THERMAL2_SCHEDULER_H_
+#define _M5_THERMAL2_SCHEDULER_H_
+
+#include "M5_Thermal2.h"
+
+class M5_Thermal2_Scheduler {
+   public:
+    typedef M5_Thermal2::temperature_data_t temperature_data_t;
+
+    static constexpr uint8_t unit_max = 8;
+
+    /*! @brief Called for every subpage obtained.
+        @param unit_id value returned by addUnit().
+        @param usec micros() when the last pixel chunk was read.
+        @param data valid until the unit updates again. */
+    typedef void (*frame_callback_t)(void* user, uint8_t unit_id,
+                                     uint32_t usec,
+                                     const temperature_data_t& data);
+
+    struct unit_stats_t {
+        uint32_t frames;     // subpages obtained.
+        uint32_t not_ready;  // updates started before the subpage was ready.
+        uint32_t failures;   // other failed updates.
+        uint64_t busy_usec;  // time spent in poll().
+    };
+
+    /*! @brief Add a unit. begin() must have been called on it.
+        @return unit id (0 ~ unit_max-1) / -1:failure */
+    int addUnit(M5_Thermal2* unit);
+
+    inline void setCallback(frame_callback_t callback, void* user = nullptr) {
+        _callback = callback;
+        _user     = user;
+    }
+
+    /*! @brief Advance each bus by at most one transaction. Call from loop().
+        @return number of subpages delivered by this call */
+    uint8_t update(void);
+
+    /*! @brief Time until the next unit is due. (usec)
+        @return 0 when an update is in progress or due now. A loop may sleep
+                this long between update() calls. */
+    uint32_t getIdleMicros(void) const;
+
+    inline uint8_t getUnitCount(void) const {
+        return _unit_count;
+    }
+    inline M5_Thermal2* getUnit(uint8_t unit_id) const {
+        return (unit_id < _unit_count) ? _unit[unit_id].unit : nullptr;
+    }
+
+    inline const unit_stats_t& getUnitStats(uint8_t unit_id) const {
+        return _unit[(unit_id < _unit_count) ? unit_id : 0].stats;
+    }
+    /*! @brief Subpages per second of a unit since resetStats(). */
+    float getUnitFps(uint8_t unit_id) const;
+    /*! @brief Subpages per second of all units since resetStats(). */
+    float getTotalFps(void) const;
+    /*! @brief Share of the time the units on a bus spent in poll() since
+               resetStats(). (0.0 ~ 1.0)
+        @param wire nullptr: all buses, summed. */
+    float getBusUtilization(const TwoWire* wire = nullptr) const;
+    void resetStats(void);
+
+   private:
+    struct unit_t {
+        M5_Thermal2* unit;
+        TwoWire* wire;
+        uint32_t due_usec;  // micros() from which the unit may start.
+        unit_stats_t stats;
+    };
+
+    struct bus_t {
+        TwoWire* wire;
+        uint8_t turn;  // unit stepped last, for round robin.
+    };
+
+    unit_t _unit[unit_max];
+    bus_t _bus[unit_max];
+    uint8_t _unit_count        = 0;
+    uint8_t _bus_count         = 0;
+    frame_callback_t _callback = nullptr;
+    void* _user                = nullptr;
+    uint32_t _stats_start_usec = 0;
+
+    void _schedule(unit_t& u, M5_Thermal2::update_state_t state,
+                   uint32_t now);
+};
+
+#endif
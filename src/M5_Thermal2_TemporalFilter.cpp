@@ -0,0 +1,66 @@
+#include "M5_Thermal2_TemporalFilter.h"
+
+// Pixels per row of a subpage.
+static constexpr uint8_t row_pixels = M5_Thermal2::frame_width / 2;
+
+M5_Thermal2_TemporalFilter::M5_Thermal2_TemporalFilter(void) {
+    setParam(_strength, _noise_raw);
+}
+
+void M5_Thermal2_TemporalFilter::setParam(uint8_t strength,
+                                          uint16_t noise_raw) {
+    if (strength > 7) strength = 7;
+    _strength  = strength;
+    _noise_raw = noise_raw;
+
+    const int32_t base  = 256 >> strength;
+    const int32_t ramp0 = noise_raw;
+    const int32_t ramp1 = (int32_t)noise_raw << 2;
+    for (size_t i = 0; i < lut_size; ++i) {
+        int32_t d = i << lut_shift;
+        int32_t g = 256;
+        if (d <= ramp0) {
+            g = base;
+        } else if (d < ramp1) {
+            g = base + (256 - base) * (d - ramp0) / (ramp1 - ramp0);
+        }
+        _gain[i] = g;
+    }
+    // Beyond the table every change passes, which also keeps the product
+    // in filter() within int32_t.
+    _gain[lut_size - 1] = 256;
+}
+
+bool M5_Thermal2_TemporalFilter::filter(temperature_data_t& data) {
+    const uint_fast8_t sp      = data.subpage;
+    uint16_t* __restrict pixel = data.pixel_raw;
+    uint32_t* __restrict state = _state[sp];
+    if (!(_primed & (1 << sp))) {
+        _primed |= 1 << sp;
+        for (uint_fast16_t i = 0; i < M5_Thermal2::subpage_pixels; ++i) {
+            state[i] = (uint32_t)pixel[i] << 8;
+        }
+        return false;
+    }
+
+    const uint16_t* __restrict gain = _gain;
+    // Stale rows hold the previous content, already filtered: their state
+    // waits for the next sample actually read.
+    const uint32_t stale = data.stale_rows;
+    for (uint_fast8_t y = 0; y < M5_Thermal2::frame_height; ++y) {
+        if ((stale >> y) & 1) continue;
+        const uint_fast16_t end = (y + 1) * row_pixels;
+        for (uint_fast16_t i = y * row_pixels; i < end; ++i) {
+            int32_t s    = state[i];
+            int32_t diff = ((int32_t)pixel[i] << 8) - s;
+            uint32_t ad =
+                (uint32_t)((diff < 0) ? -diff : diff) >> (8 + lut_shift);
+            int32_t g = gain[(ad < lut_size) ? ad : lut_size - 1];
+            // g < 256 only below the last entry, so |diff * g| < 2^26.
+            s        = (g == 256) ? (s + diff) : (s + ((diff * g) >> 8));
+            state[i] = s;
+            pixel[i] = (s + 128) >> 8;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,67 @@
+/*!
+ * @brief Per-pixel temporal noise filter for Unit Thermal2 subpages.
+ * @copyright Copyright (c) 2022 by M5Stack[https://m5stack.com]
+ *
+ * A host-side replacement for the unit's noise filter. (setNoiseFilterLevel)
+ * Each pixel runs a fixed-point first order IIR whose gain depends on how
+ * far the new sample is from the filtered value: changes within the noise
+ * level are smoothed strongly, larger changes pass at once. The gain comes
+ * from a LUT, so a pixel costs one subtraction, one lookup and one multiply.
+ *
+ * The two checkerboard subpages cover different pixels, so each pixel is
+ * filtered only against earlier samples of its own subpage. Filter the
+ * subpage before M5_Thermal2_FrameAssembler::merge().
+ */
+#ifndef _M5_THERMAL2_TEMPORALFILTER_H_
+#define _M5_THERMAL2_TEMPORALFILTER_H_
+
+#include "M5_Thermal2.h"
+
+class M5_Thermal2_TemporalFilter {
+   public:
+    typedef M5_Thermal2::temperature_data_t temperature_data_t;
+
+    static constexpr size_t lut_size  = 256;
+    /// Raw values per LUT entry: 1 << lut_shift.
+    static constexpr uint8_t lut_shift = 2;
+
+    M5_Thermal2_TemporalFilter(void);
+
+    /*! @brief Set the filter response.
+        @param strength 0 (off) ~ 7. A change within the noise level moves
+                        the output by 1/2^strength of the difference.
+        @param noise_raw Largest change treated as noise. (raw, 128 = 1.0
+                         degree Celsius) Changes from noise_raw to
+                         4 * noise_raw are smoothed less and less, larger
+                         ones pass unfiltered. */
+    void setParam(uint8_t strength, uint16_t noise_raw = 32);
+
+    inline uint8_t getStrength(void) const {
+        return _strength;
+    }
+    inline uint16_t getNoiseRaw(void) const {
+        return _noise_raw;
+    }
+
+    /*! @brief Filter a subpage in place.
+        @brief Only pixel_raw is filtered. temperature_reg keeps the unit's
+               overview of the unfiltered subpage. Stale rows
+               (setPixelRows) are left as they are, and so is their state.
+        @return true: filtered / false: first sample of this subpage, passed
+                through */
+    bool filter(temperature_data_t& data);
+
+    /*! @brief Forget the filtered values. The next subpages pass through. */
+    inline void reset(void) {
+        _primed = 0;
+    }
+
+   private:
+    uint32_t _state[2][M5_Thermal2::subpage_pixels];  // raw << 8
+    uint16_t _gain[lut_size];                        // 256 = follow at once
+    uint16_t _noise_raw = 32;
+    uint8_t _strength   = 3;
+    uint8_t _primed     = 0;  // bit per subpage
+};
+
+#endif
@@ -0,0 +1,269 @@
+/*!
+ * @brief Sliding-window statistics of the overview temperatures.
+ * @copyright Copyright (c) 2022 by M5Stack[https://m5stack.com]
+ *
+ * Keeps the last N overview samples (lowest, highest, median and average of
+ * temperature_reg_t) and, for up to W windows of different lengths over the
+ * same samples, the minimum, maximum, mean and least-squares slope of each
+ * channel. Nothing is rescanned: each push costs a constant number of steps
+ * per window and channel, amortised.
+ *
+ *   - min / max : one monotonic deque per channel and direction, shared by
+ *                 all windows. Each window keeps its own front position in
+ *                 it, which only moves forward.
+ *   - mean      : running sum per window.
+ *   - slope     : running sum of (position in window x value) per window,
+ *                 shifted when the oldest sample leaves.
+ *
+ * All storage is inside the object, about 28 bytes per sample of capacity
+ * (28 KB with the default N), nothing is allocated.
+ */
+#ifndef _M5_THERMAL2_TIMESERIES_H_
+#define _M5_THERMAL2_TIMESERIES_H_
+
+#include "M5_Thermal2.h"
+
+#include <stddef.h>
+
+/*! @brief Overview temperature time series.
+    @tparam N Samples kept, and the longest window. (power of 2, 2 to 32768)
+    @tparam W Number of windows. */
+template <size_t N = 1024, uint8_t W = 4>
+class M5_Thermal2_TimeSeries {
+    static_assert(N >= 2 && N <= 32768 && (N & (N - 1)) == 0,
+                  "N must be a power of 2, up to 32768");
+    static_assert(W >= 1, "W must be 1 or more");
+
+   public:
+    enum channel_t : uint8_t {
+        channel_lowest,
+        channel_highest,
+        channel_median,
+        channel_average,
+        channel_max,
+    };
+
+    /// Statistics of one channel over one window.
+    struct stats_t {
+        uint32_t count;  // samples in the window.
+        uint32_t usec;   // from the oldest to the newest sample.
+        uint16_t lowest_raw;
+        uint16_t highest_raw;
+        float mean_raw;
+        float slope_raw;  // least-squares slope, raw per sample.
+
+        inline float getLowestTemperature(void) const {
+            return M5_Thermal2::convertRawToCelsius(lowest_raw);
+        }
+        inline float getHighestTemperature(void) const {
+            return M5_Thermal2::convertRawToCelsius(highest_raw);
+        }
+        inline float getMeanTemperature(void) const {
+            return mean_raw / 128.0f - 64.0f;
+        }
+        /*! @brief Slope in celsius per second, from the sample timestamps.
+            @return 0 when the window spans no time. */
+        inline float getSlopePerSecond(void) const {
+            if (usec == 0) return 0.0f;
+            return slope_raw * (count - 1) * (1e6f / 128.0f) / usec;
+        }
+    };
+
+    M5_Thermal2_TimeSeries(void) {
+        for (uint8_t w = 0; w < W; ++w) _window[w].length = N;
+        clear();
+    }
+
+    /*! @brief Set the length of a window. (all windows are N by default)
+        @brief The window statistics are recomputed from the kept samples.
+        @param index 0 to W-1
+        @param length samples, 1 to N
+        @return true:success / false:failure */
+    bool setWindow(uint8_t index, uint32_t length) {
+        if (index >= W || length < 1 || length > N) return false;
+        _window[index].length = length;
+        _rebuild(_window[index]);
+        return true;
+    }
+    inline uint32_t getWindow(uint8_t index) const {
+        return _window[index].length;
+    }
+
+    /*! @brief Add a sample.
+        @param reg overview. (temperature_data_t::temperature_reg, only
+                   updated with profile_full)
+        @param usec micros() of the sample. */
+    void push(const M5_Thermal2::temperature_reg_t& reg, uint32_t usec) {
+        const uint16_t value[channel_max] = {reg.lowest_raw, reg.highest_raw,
+                                             reg.median_raw, reg.average_raw};
+        const uint16_t seq  = _count;
+        const uint32_t slot = seq & (N - 1);
+
+        // Sums first: the sample leaving a window of length N is in the slot
+        // about to be overwritten.
+        for (uint_fast8_t w = 0; w < W; ++w) {
+            window_t& win = _window[w];
+            uint32_t n    = (_size < win.length) ? _size : win.length;
+            for (uint_fast8_t c = 0; c < channel_max; ++c) {
+                win.weighted[c] += (int64_t)n * value[c];
+                win.sum[c] += value[c];
+                if (n == win.length) {
+                    win.sum[c] -= _raw[c][(seq - n) & (N - 1)];
+                    win.weighted[c] -= win.sum[c];
+                }
+            }
+        }
+
+        for (uint_fast8_t c = 0; c < channel_max; ++c) {
+            for (uint_fast8_t k = 0; k < 2; ++k) {
+                _pushDeque(_deque[c][k], c, k, value[c], seq);
+            }
+        }
+
+        for (uint_fast8_t c = 0; c < channel_max; ++c) {
+            _raw[c][slot] = value[c];
+        }
+        _usec[slot] = usec;
+        ++_count;
+        if (_size < N) ++_size;
+    }
+    inline void push(const M5_Thermal2::temperature_data_t& data,
+                     uint32_t usec) {
+        push(data.temperature_reg, usec);
+    }
+
+    /*! @brief Statistics of a channel over a window. (O(1))
+        @return stats, count 0 when no sample was pushed */
+    stats_t getStats(uint8_t index, channel_t channel) const {
+        stats_t s         = {};
+        const window_t& w = _window[index];
+        uint32_t n        = (_size < w.length) ? _size : w.length;
+        if (n == 0) return s;
+        const uint16_t* raw = _raw[channel];
+        const deque_t& lo   = _deque[channel][0];
+        const deque_t& hi   = _deque[channel][1];
+        uint16_t lo_seq     = lo.seq[w.front[channel][0] & (N - 1)];
+        uint16_t hi_seq     = hi.seq[w.front[channel][1] & (N - 1)];
+
+        s.count       = n;
+        s.usec        = getMicros(0) - getMicros(n - 1);
+        s.lowest_raw  = raw[lo_seq & (N - 1)];
+        s.highest_raw = raw[hi_seq & (N - 1)];
+        s.mean_raw    = (float)w.sum[channel] / n;
+        if (n > 1) {
+            // x = 0 (oldest) to n-1 (newest).
+            int64_t sx  = (int64_t)n * (n - 1) / 2;
+            int64_t sxx = (int64_t)n * (n - 1) * (2 * n - 1) / 6;
+            int64_t num = (int64_t)n * w.weighted[channel] -
+                          sx * (int64_t)w.sum[channel];
+            int64_t den = (int64_t)n * sxx - sx * sx;
+            s.slope_raw = (float)num / (float)den;
+        }
+        return s;
+    }
+
+    /*! @brief Number of kept samples. (up to N) */
+    inline uint32_t size(void) const {
+        return _size;
+    }
+    /*! @brief Kept sample, for drawing a graph.
+        @param age 0:newest to size()-1:oldest */
+    inline uint16_t getRaw(channel_t channel, uint32_t age) const {
+        return _raw[channel][(_count - 1 - age) & (N - 1)];
+    }
+    inline uint32_t getMicros(uint32_t age) const {
+        return _usec[(_count - 1 - age) & (N - 1)];
+    }
+
+    /*! @brief Drop all samples. (the window lengths are kept) */
+    void clear(void) {
+        _count = 0;
+        _size  = 0;
+        for (uint_fast8_t c = 0; c < channel_max; ++c) {
+            for (uint_fast8_t k = 0; k < 2; ++k) {
+                _deque[c][k].head = 0;
+                _deque[c][k].tail = 0;
+            }
+        }
+        for (uint_fast8_t w = 0; w < W; ++w) _rebuild(_window[w]);
+    }
+
+   private:
+    // Sequence numbers (low 16 bits) of the candidates, oldest first, with
+    // increasing (k = 0, minimum) or decreasing (k = 1, maximum) values.
+    // head / tail are positions; the slot of a position is & (N - 1).
+    struct deque_t {
+        uint16_t seq[N];
+        uint32_t head;
+        uint32_t tail;
+    };
+
+    struct window_t {
+        uint32_t length;
+        uint32_t front[channel_max][2];  // first deque position inside.
+        uint32_t sum[channel_max];
+        int64_t weighted[channel_max];  // sum of x * value, x = 0 oldest.
+    };
+
+    uint16_t _raw[channel_max][N];
+    uint32_t _usec[N];
+    deque_t _deque[channel_max][2];
+    window_t _window[W];
+    uint32_t _count = 0;  // samples pushed. (low 16 bits: next seq)
+    uint32_t _size  = 0;
+
+    // Age of a sequence number relative to the sample being pushed, or the
+    // newest one after the push.
+    static inline uint16_t _age(uint16_t newest, uint16_t seq) {
+        return newest - seq;
+    }
+
+    void _pushDeque(deque_t& d, uint_fast8_t c, uint_fast8_t k,
+                    uint16_t value, uint16_t seq) {
+        // The sample leaving the longest window.
+        if (d.head != d.tail && _age(seq, d.seq[d.head & (N - 1)]) >= N) {
+            ++d.head;
+        }
+        // Candidates that can no longer be the minimum (maximum).
+        while (d.head != d.tail) {
+            uint16_t back = _raw[c][d.seq[(d.tail - 1) & (N - 1)] & (N - 1)];
+            if (k ? (back > value) : (back < value)) break;
+            --d.tail;
+        }
+        uint32_t pos         = d.tail;
+        d.seq[pos & (N - 1)] = seq;
+        ++d.tail;
+
+        for (uint_fast8_t w = 0; w < W; ++w) {
+            uint32_t& front = _window[w].front[c][k];
+            uint32_t length  = _window[w].length;
+            if ((int32_t)(front - d.head) < 0) front = d.head;
+            if ((int32_t)(front - pos) > 0) front = pos;
+            while (_age(seq, d.seq[front & (N - 1)]) >= length) ++front;
+        }
+    }
+
+    void _rebuild(window_t& win) {
+        uint32_t n = (_size < win.length) ? _size : win.length;
+        for (uint_fast8_t c = 0; c < channel_max; ++c) {
+            win.sum[c]      = 0;
+            win.weighted[c] = 0;
+            for (uint32_t x = 0; x < n; ++x) {
+                uint16_t v = getRaw((channel_t)c, n - 1 - x);
+                win.sum[c] += v;
+                win.weighted[c] += (int64_t)x * v;
+            }
+            for (uint_fast8_t k = 0; k < 2; ++k) {
+                const deque_t& d = _deque[c][k];
+                uint32_t front   = d.head;
+                if (n) {
+                    uint16_t newest = _count - 1;
+                    while (_age(newest, d.seq[front & (N - 1)]) >= n) ++front;
+                }
+                win.front[c][k] = front;
+            }
+        }
+    }
+};
+
+#endif